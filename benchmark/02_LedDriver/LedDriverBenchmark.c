@@ -0,0 +1,370 @@
+/**
+ * @file    LedDriverBenchmark.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Throughput benchmark of the LedDriver module (run it with "make benchmark_leddriver").
+ *
+ *          Every workload runs a number of logical operations (a TurnOn(), a TurnAllOff(), an Apply(), ...)
+ *          against LED registers in memory and reports:
+ *          - ns/op and Mops/s
+ *          - hardware updates per operation, counted through the update hook (LedDriver_SetUpdateHook())
+ *          - register writes per operation (LedDriver_GetRegisterWriteCount())
+ *
+ *          The single LED workload is run once more with a trace attached (LedDriver_SetTrace()), which adds the
+ *          cost of a timestamp (LedTrace_GetTimestamp()) and of a trace entry to every change.
+ *
+ *          The LedPwm tick is measured too (ns/tick and the PWM refresh rate that cost allows, a period being
+ *          LEDPWM_TICKS_PER_PERIOD ticks), with a new brightness set every period.
+ *
+ *          Concurrent mode is measured with 1, 2 and 4 threads on two workloads (ns/op and Mops/s of all the threads
+ *          together, the hook and the write counter are left out since a shared counter would serialize the threads):
+ *          - shared register: every thread toggles its own LEDs of the same 64-bit register, so all of them contend
+ *            for one image word and one register
+ *          - own register: every thread toggles the LEDs of its own 64-bit register, the image words and registers
+ *            of the threads being a cache line apart, so nothing is shared and the throughput should scale
+ *
+ *          The number of operations per workload can be given as the first argument (default 5000000).
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LedDriver.h"
+#include "LedPwm.h"
+#include "LedTrace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>    /* clock_gettime() */
+#include <pthread.h> /* pthread_create() / pthread_join() */
+
+enum { BOARD_LEDS = 16, BANK_LEDS = 1024, BANK_REGISTERS = BANK_LEDS / 16, BANK_WORDS = BANK_LEDS / LED_WORD_BITS };
+enum { FRAME_CHANGES = 32, MAX_THREADS = 4, SHARED_LEDS = 64, TRACE_CAPACITY = 1024 };
+
+/* own register workload: 512 LEDs (64 bytes of image and of 64-bit registers) between the LEDs of two threads,
+   the first 512 being left unused so that no thread writes next to the driver fields */
+enum { OWN_STRIDE = 512, OWN_LEDS = ( MAX_THREADS + 1 ) * OWN_STRIDE, OWN_REGISTERS = OWN_LEDS / 64 };
+
+/* LED registers in memory */
+static uint16_t boardRegister;
+static uint16_t bankRegisters[ BANK_REGISTERS ];
+static uint64_t sharedRegister;
+static uint64_t ownRegisters[ OWN_REGISTERS ] __attribute__( ( aligned( 64 ) ) );
+
+/* hardware updates counted by the instrumentation hook (threads may update concurrently) */
+static uint64_t hardwareUpdates;
+
+static void countHardwareUpdate( void *context, LedDriver self )
+{
+    ( void ) self;
+    __atomic_fetch_add( ( uint64_t * ) context, 1, __ATOMIC_RELAXED );
+}
+
+static uint64_t nowNs( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( uint64_t ) now.tv_sec * 1000000000u + ( uint64_t ) now.tv_nsec;
+}
+
+/* xorshift pseudo-random numbers, cheap enough not to show in the measurements */
+static uint32_t nextRandom( uint32_t *state )
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+
+    return *state;
+}
+
+/* workloads: every one runs 'ops' logical operations on 'leds' */
+
+static void singleLed( LedDriver leds, long ops )
+{
+    long i;
+    uint16_t ledCount = LedDriver_GetLedCount( leds );
+
+    for ( i = 0; i < ops; i += 2 )
+    {
+        uint16_t ledNumber = ( uint16_t ) ( ( i / 2 ) % ledCount + 1 );
+
+        LedDriver_TurnOn( leds, ledNumber );
+        LedDriver_TurnOff( leds, ledNumber );
+    }
+}
+
+static void allLeds( LedDriver leds, long ops )
+{
+    long i;
+
+    for ( i = 0; i < ops; i += 2 )
+    {
+        LedDriver_TurnAllOn( leds );
+        LedDriver_TurnAllOff( leds );
+    }
+}
+
+static void mixed( LedDriver leds, long ops )
+{
+    long i;
+    int w;
+    uint32_t state = 2463534242u;
+    uint16_t ledCount = LedDriver_GetLedCount( leds );
+    LedWord onMask[ BANK_WORDS ];
+    LedWord offMask[ BANK_WORDS ];
+    volatile BOOL sink;
+
+    /* 40% turn on, 40% turn off, 10% queries, 10% masked updates of random LEDs */
+    for ( i = 0; i < ops; i++ )
+    {
+        uint32_t random = nextRandom( &state );
+        uint16_t ledNumber = ( uint16_t ) ( ( random >> 8 ) % ledCount + 1 );
+
+        switch ( random % 10 )
+        {
+            case 0: case 1: case 2: case 3:
+                LedDriver_TurnOn( leds, ledNumber );
+                break;
+
+            case 4: case 5: case 6: case 7:
+                LedDriver_TurnOff( leds, ledNumber );
+                break;
+
+            case 8:
+                sink = LedDriver_IsOn( leds, ledNumber );
+                break;
+
+            default:
+                for ( w = 0; w < BANK_WORDS; w++ )
+                {
+                    onMask[ w ]  = ( LedWord ) ( ( ( uint64_t ) nextRandom( &state ) << 32 ) | nextRandom( &state ) );
+                    offMask[ w ] = ( LedWord ) ( ( ( uint64_t ) nextRandom( &state ) << 32 ) | nextRandom( &state ) );
+                }
+
+                LedDriver_Apply( leds, onMask, offMask );
+                break;
+        }
+    }
+
+    ( void ) sink;
+}
+
+static void deferredFrames( LedDriver leds, long ops )
+{
+    long i;
+    int j;
+    uint16_t ledCount = LedDriver_GetLedCount( leds );
+
+    /* FRAME_CHANGES single LED changes collapsed into every frame,
+       a frame turns on a set of LEDs and the next one turns the same set off */
+    for ( i = 0; i < ops; i += FRAME_CHANGES )
+    {
+        LedDriver_BeginUpdate( leds );
+
+        for ( j = 0; j < FRAME_CHANGES; j++ )
+        {
+            uint16_t ledNumber = ( uint16_t ) ( ( i / ( 2 * FRAME_CHANGES ) * FRAME_CHANGES + j * 7 ) % ledCount + 1 );
+
+            if ( ( i / FRAME_CHANGES ) % 2 )
+            {
+                LedDriver_TurnOn( leds, ledNumber );
+            }
+            else
+            {
+                LedDriver_TurnOff( leds, ledNumber );
+            }
+        }
+
+        LedDriver_Flush( leds );
+    }
+}
+
+static void report( const char *name, long ops, uint64_t ns, uint64_t updates, uint32_t writes )
+{
+    printf( "%-32s %9.2f ns/op %9.2f Mops/s %7.3f updates/op %7.3f writes/op\n",
+            name, ( double ) ns / ops, ops * 1e3 / ns, ( double ) updates / ops, ( double ) writes / ops );
+}
+
+static void run( const char *name, void ( *workload )( LedDriver, long ), LedDriver leds, long ops )
+{
+    uint64_t start;
+    uint64_t ns;
+    uint32_t writes = LedDriver_GetRegisterWriteCount( leds );
+
+    hardwareUpdates = 0;
+
+    start = nowNs();
+    workload( leds, ops );
+    ns = nowNs() - start;
+
+    report( name, ops, ns, hardwareUpdates, LedDriver_GetRegisterWriteCount( leds ) - writes );
+}
+
+/* software PWM: every LED of the bank at its own brightness, one LED changes brightness every period */
+
+static void runPwm( LedDriver leds, long ticks )
+{
+    LedPwm pwm = LedPwm_Create( leds );
+    uint16_t ledCount = LedDriver_GetLedCount( leds );
+    uint32_t state = 88675123u;
+    uint32_t writes;
+    uint64_t start;
+    uint64_t ns;
+    long i;
+    uint16_t ledNumber;
+
+    for ( ledNumber = 1; ledNumber <= ledCount; ledNumber++ )
+    {
+        LedPwm_SetBrightness( pwm, ledNumber, ( uint8_t ) nextRandom( &state ) );
+    }
+
+    writes = LedDriver_GetRegisterWriteCount( leds );
+    hardwareUpdates = 0;
+
+    start = nowNs();
+
+    for ( i = 0; i < ticks; i++ )
+    {
+        if ( i % LEDPWM_TICKS_PER_PERIOD == 0 )
+        {
+            LedPwm_SetBrightness( pwm, ( uint16_t ) ( i / LEDPWM_TICKS_PER_PERIOD % ledCount + 1 ),
+                                  ( uint8_t ) nextRandom( &state ) );
+        }
+
+        LedPwm_Tick( pwm );
+    }
+
+    ns = nowNs() - start;
+
+    report( "PWM tick, 1024 LED bank", ticks, ns, hardwareUpdates, LedDriver_GetRegisterWriteCount( leds ) - writes );
+    printf( "%-32s %9.0f Hz max PWM refresh (%d ticks per period)\n", "",
+            ticks * 1e9 / ns / LEDPWM_TICKS_PER_PERIOD, LEDPWM_TICKS_PER_PERIOD );
+
+    LedPwm_Destroy( pwm );
+}
+
+/* concurrent mode: every thread toggles the LEDs first, first + stride, ... up to last */
+
+typedef struct ThreadArgs
+{
+    LedDriver leds;
+    uint16_t first;
+    uint16_t stride;
+    uint16_t last;
+    long ops;
+} ThreadArgs;
+
+static void *toggleOwnLeds( void *arg )
+{
+    ThreadArgs *args = arg;
+    long i;
+    uint16_t ledNumber = args->first;
+
+    for ( i = 0; i < args->ops; i += 2 )
+    {
+        LedDriver_TurnOn( args->leds, ledNumber );
+        LedDriver_TurnOff( args->leds, ledNumber );
+
+        ledNumber += args->stride;
+
+        if ( ledNumber > args->last )
+        {
+            ledNumber = args->first;
+        }
+    }
+
+    return NULL;
+}
+
+static void runConcurrent( int threads, long ops, BOOL ownRegister )
+{
+    char name[ 64 ];
+    pthread_t ids[ MAX_THREADS ];
+    ThreadArgs args[ MAX_THREADS ];
+    LedDriver leds = ownRegister ? LedDriver_CreateBank( ownRegisters, OWN_LEDS, 64 )
+                                 : LedDriver_CreateBank( &sharedRegister, SHARED_LEDS, 64 );
+    uint64_t start;
+    uint64_t ns;
+    int t;
+
+    LedDriver_SetConcurrent( leds, TRUE );
+
+    /* the operations are split between the threads, so Mops/s is the throughput of all of them together */
+    start = nowNs();
+
+    for ( t = 0; t < threads; t++ )
+    {
+        args[ t ].leds = leds;
+        args[ t ].ops  = ops / threads;
+
+        if ( ownRegister )
+        {
+            args[ t ].first  = ( uint16_t ) ( ( t + 1 ) * OWN_STRIDE + 1 );
+            args[ t ].stride = 1;
+            args[ t ].last   = ( uint16_t ) ( ( t + 1 ) * OWN_STRIDE + 64 );
+        }
+        else
+        {
+            args[ t ].first  = ( uint16_t ) ( t + 1 );
+            args[ t ].stride = ( uint16_t ) threads;
+            args[ t ].last   = SHARED_LEDS;
+        }
+
+        pthread_create( &ids[ t ], NULL, toggleOwnLeds, &args[ t ] );
+    }
+
+    for ( t = 0; t < threads; t++ )
+    {
+        pthread_join( ids[ t ], NULL );
+    }
+
+    ns = nowNs() - start;
+
+    snprintf( name, sizeof( name ), "%s, %d thread(s)", ownRegister ? "own register" : "shared register", threads );
+    printf( "%-32s %9.2f ns/op %9.2f Mops/s\n", name, ( double ) ns / ops, ops * 1e3 / ns );
+
+    LedDriver_Destroy( leds );
+}
+
+int main( int argc, char **argv )
+{
+    long ops = ( argc > 1 ) ? atol( argv[ 1 ] ) : 5000000;
+    LedDriver board = LedDriver_Create( &boardRegister );
+    LedDriver bank  = LedDriver_CreateBank( bankRegisters, BANK_LEDS, 16 );
+    LedTrace trace  = LedTrace_Create( TRACE_CAPACITY );
+    int threads;
+
+    LedDriver_SetUpdateHook( board, countHardwareUpdate, &hardwareUpdates );
+    LedDriver_SetUpdateHook( bank, countHardwareUpdate, &hardwareUpdates );
+
+    printf( "LedDriver benchmark, %ld operations per workload, %d-bit image words\n\n", ops, LED_WORD_BITS );
+
+    run( "single LED, 16 LED board", singleLed, board, ops );
+    run( "all LEDs, 16 LED board", allLeds, board, ops );
+    run( "single LED, 1024 LED bank", singleLed, bank, ops );
+    LedDriver_SetTrace( bank, trace );
+    run( "traced LED, 1024 LED bank", singleLed, bank, ops );
+    LedDriver_SetTrace( bank, NULL );
+    run( "all LEDs, 1024 LED bank", allLeds, bank, ops );
+    run( "mixed, 1024 LED bank", mixed, bank, ops );
+    run( "deferred frames, 1024 LED bank", deferredFrames, bank, ops );
+    runPwm( bank, ops );
+
+    printf( "\nconcurrent mode\n" );
+
+    for ( threads = 1; threads <= MAX_THREADS; threads *= 2 )
+    {
+        runConcurrent( threads, ops, FALSE );
+    }
+
+    for ( threads = 1; threads <= MAX_THREADS; threads *= 2 )
+    {
+        runConcurrent( threads, ops, TRUE );
+    }
+
+    LedDriver_Destroy( board );
+    LedDriver_Destroy( bank );
+    LedTrace_Destroy( trace );
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file    LightSchedulerBenchmark.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Bulk edit benchmark of the LightScheduler module (run it with "make benchmark_lightscheduler").
+ *
+ *          The Light Controller and the Time Service are the spy and the fake used by the tests,
+ *          so only the scheduler's own bookkeeping is measured. Every workload reports ns/op:
+ *          - scheduling the events one at a time
+ *          - randomizing every one of them
+ *          - looking up the next due event from every minute of a week (the due-check on its own)
+ *          - waking up at every minute of a week
+ *          - removing the events one at a time, in a shuffled order
+ *          - importing the same events from a CSV file and from a binary file (into a new light scheduler each)
+ *
+ *          The number of events can be given as the first argument (default 10000).
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LightScheduler.h"
+#include "LightControllerSpy.h"
+#include "FakeTimeService.h"
+#include "RandomMinute.h"
+#include "LightSchedulerImport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>   /* clock_gettime() */
+#include <unistd.h> /* mkstemp() / close() / unlink() */
+
+enum { MINUTES_PER_DAY = 1440 };
+
+/* key of the scheduled event number i (keys only repeat after 32 weeks worth of minutes) */
+#define EVENT_ID( i )     ( ( int ) ( ( i ) / ( 7 * MINUTES_PER_DAY ) % MAX_LIGHTS_NUMBER ) )
+#define EVENT_DAY( i )    ( ( Day ) ( SUNDAY + ( i ) / MINUTES_PER_DAY % 7 ) )
+#define EVENT_MINUTE( i ) ( ( int ) ( ( i ) % MINUTES_PER_DAY ) )
+
+static uint64_t nowNs( void )
+{
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( uint64_t ) now.tv_sec * 1000000000u + ( uint64_t ) now.tv_nsec;
+}
+
+/* xorshift pseudo-random numbers */
+static uint32_t nextRandom( uint32_t *state )
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+
+    return *state;
+}
+
+static void report( const char *name, long ops, uint64_t ns )
+{
+    printf( "%-36s %9.2f ns/op %10.3f ms total\n", name, ( double ) ns / ops, ns / 1e6 );
+}
+
+static void writeCsv( const char *path, long events )
+{
+    static const char *dayNames[] = { "SUNDAY", "MONDAY", "TUESDAY", "WEDNESDAY", "THURSDAY", "FRIDAY", "SATURDAY" };
+    FILE *file = fopen( path, "w" );
+    long i;
+
+    for ( i = 0; i < events; i++ )
+    {
+        fprintf( file, "on, %d, %s, %d\n", EVENT_ID( i ), dayNames[ EVENT_DAY( i ) - SUNDAY ], EVENT_MINUTE( i ) );
+    }
+
+    fclose( file );
+}
+
+static void writeBinary( const char *path, long events )
+{
+    unsigned char record[ LS_IMPORT_RECORD_SIZE ];
+    FILE *file = fopen( path, "wb" );
+    long i;
+
+    fwrite( LS_IMPORT_MAGIC, 1, LS_IMPORT_MAGIC_SIZE, file );
+
+    for ( i = 0; i < events; i++ )
+    {
+        LightSchedulerImport_EncodeRecord( 1, EVENT_ID( i ), ( Days ) ( 1 << ( EVENT_DAY( i ) - SUNDAY ) ), EVENT_MINUTE( i ), record );
+        fwrite( record, 1, sizeof( record ), file );
+    }
+
+    fclose( file );
+}
+
+static long benchmarkImport( const char *name, long events, long ( *import )( LightScheduler, const char *, ImportErrorCallback, void * ),
+                             const char *path )
+{
+    LightScheduler imported = LightScheduler_Create();
+    uint64_t start = nowNs();
+    long count = import( imported, path, NULL, NULL );
+
+    report( name, events, nowNs() - start );
+    LightScheduler_Destroy( imported );
+
+    /* every row is an event */
+    return count != events;
+}
+
+int main( int argc, char **argv )
+{
+    long events = ( argc > 1 ) ? atol( argv[ 1 ] ) : 10000;
+    long *order = malloc( ( size_t ) events * sizeof( long ) );
+    uint32_t seed = 2463534242u;
+    LightScheduler scheduler;
+    uint64_t start;
+    long failures = 0;
+    long i;
+    int day, minute;
+
+    RandomMinute_Create( 30 );
+    LightController_Create();
+    scheduler = LightScheduler_Create();
+
+    printf( "LightScheduler benchmark, %ld events\n\n", events );
+
+    /* schedule */
+    start = nowNs();
+
+    for ( i = 0; i < events; i++ )
+    {
+        failures += LightScheduler_ScheduleTurnOn( scheduler, EVENT_ID( i ), EVENT_DAY( i ), EVENT_MINUTE( i ) ) != LS_OK;
+    }
+
+    report( "schedule, one at a time", events, nowNs() - start );
+
+    /* randomize */
+    start = nowNs();
+
+    for ( i = 0; i < events; i++ )
+    {
+        LightScheduler_Randomize( scheduler, EVENT_ID( i ), EVENT_DAY( i ), EVENT_MINUTE( i ) );
+    }
+
+    report( "randomize, one at a time", events, nowNs() - start );
+
+    /* next due event from every minute of the week, the schedule is left untouched */
+    start = nowNs();
+
+    for ( day = SUNDAY; day <= SATURDAY; day++ )
+    {
+        for ( minute = 0; minute < MINUTES_PER_DAY; minute++ )
+        {
+            FakeTimeService_SetDay( day );
+            FakeTimeService_SetMinute( minute );
+            failures += LightScheduler_NextDue( scheduler ) == LS_NOTHING_DUE;
+        }
+    }
+
+    report( "next due, every minute of a week", 7 * MINUTES_PER_DAY, nowNs() - start );
+
+    /* one wake-up per minute of the week */
+    start = nowNs();
+
+    for ( day = SUNDAY; day <= SATURDAY; day++ )
+    {
+        for ( minute = 0; minute < MINUTES_PER_DAY; minute++ )
+        {
+            FakeTimeService_SetDay( day );
+            FakeTimeService_SetMinute( minute );
+            LightScheduler_WakeUp( scheduler );
+        }
+    }
+
+    report( "wake-up, every minute of a week", 7 * MINUTES_PER_DAY, nowNs() - start );
+
+    /* shuffle the removal order (Fisher-Yates) */
+    for ( i = 0; i < events; i++ )
+    {
+        order[ i ] = i;
+    }
+
+    for ( i = events - 1; i > 0; i-- )
+    {
+        long j = ( long ) ( nextRandom( &seed ) % ( uint32_t ) ( i + 1 ) );
+        long swap = order[ i ];
+
+        order[ i ] = order[ j ];
+        order[ j ] = swap;
+    }
+
+    /* remove */
+    start = nowNs();
+
+    for ( i = 0; i < events; i++ )
+    {
+        long event = order[ i ];
+
+        failures += LightScheduler_ScheduleRemove( scheduler, EVENT_ID( event ), EVENT_DAY( event ), EVENT_MINUTE( event ) ) != LS_OK;
+    }
+
+    report( "remove, one at a time (shuffled)", events, nowNs() - start );
+
+    /* bulk import (the files are written beforehand, only the import is measured) */
+    {
+        char path[] = "/tmp/LightSchedulerBenchmarkXXXXXX";
+
+        close( mkstemp( path ) );
+
+        writeCsv( path, events );
+        failures += benchmarkImport( "import, CSV file", events, LightSchedulerImport_Csv, path );
+
+        writeBinary( path, events );
+        failures += benchmarkImport( "import, binary file", events, LightSchedulerImport_Binary, path );
+
+        unlink( path );
+    }
+
+    if ( failures != 0 )
+    {
+        printf( "\n%ld schedule/remove/next due/import calls failed\n", failures );
+    }
+
+    LightScheduler_Destroy( scheduler );
+    free( order );
+
+    return failures != 0;
+}
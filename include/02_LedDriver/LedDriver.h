@@ -10,6 +10,7 @@
 #ifndef LEDDRIVER_H
 #define LEDDRIVER_H
 
+    #include <stddef.h>
     #include <stdint.h>
 
     #define TRUE     1
@@ -17,12 +18,73 @@
     
     typedef int BOOL;
 
-    void LedDriver_Create( uint16_t *virtualLeds );
-    void LedDriver_TurnOn( uint16_t ledNumber );
-    void LedDriver_TurnOff( uint16_t ledNumber );
-    void LedDriver_TurnAllOn( void );
-    void LedDriver_TurnAllOff( void );
-    BOOL LedDriver_IsOn( uint16_t ledNumber );
-    BOOL LedDriver_IsOff( uint16_t ledNumber );
+    /* The LEDs' state is stored as an array of machine words, one bit per LED.
+       Build with -DLED_WORD_BITS=32 on targets without native 64-bit operations */
+    #ifndef LED_WORD_BITS
+    #define LED_WORD_BITS 64
+    #endif
+
+    #if LED_WORD_BITS == 64
+    typedef uint64_t LedWord;
+    #elif LED_WORD_BITS == 32
+    typedef uint32_t LedWord;
+    #else
+    #error "LED_WORD_BITS must be either 32 or 64"
+    #endif
+
+    typedef struct LedDriverStruct *LedDriver; /* pointer type to a LedDriverStruct (one per LED board) */
+    typedef struct LedTraceStruct *LedTrace;   /* pointer type to a LedTraceStruct (see LedTrace.h) */
+
+    LedDriver LedDriver_Create( uint16_t *address );
+    LedDriver LedDriver_CreateBank( volatile void *address, uint16_t ledCount, int registerBits );
+    void LedDriver_Destroy( LedDriver self );
+
+    /* In-place drivers. LedDriver_Init() sets up a driver in caller-provided storage of LedDriver_SizeOf( ledCount )
+       bytes (aligned like a LedWord), e.g. one block holding the drivers of many boards one after the other.
+       Such a driver is not passed to LedDriver_Destroy(), its storage belongs to the caller */
+    size_t LedDriver_SizeOf( uint16_t ledCount );
+    LedDriver LedDriver_Init( void *storage, volatile void *address, uint16_t ledCount, int registerBits );
+
+    void LedDriver_TurnOn( LedDriver self, uint16_t ledNumber );
+    void LedDriver_TurnOff( LedDriver self, uint16_t ledNumber );
+    void LedDriver_TurnAllOn( LedDriver self );
+    void LedDriver_TurnAllOff( LedDriver self );
+    BOOL LedDriver_IsOn( LedDriver self, uint16_t ledNumber );
+    BOOL LedDriver_IsOff( LedDriver self, uint16_t ledNumber );
+    BOOL LedDriver_AreAllOn( LedDriver self );
+    BOOL LedDriver_AreAllOff( LedDriver self );
+    uint16_t LedDriver_GetLedCount( LedDriver self );
+
+    /* Masked (batch) operations. Every mask is an array with one LedWord per LED_WORD_BITS LEDs
+       of the bank (LED 1 is bit 0 of mask[ 0 ]), and the hardware is updated only once per call */
+    void LedDriver_SetMask( LedDriver self, const LedWord *onMask );
+    void LedDriver_ClearMask( LedDriver self, const LedWord *offMask );
+    void LedDriver_Apply( LedDriver self, const LedWord *onMask, const LedWord *offMask );
+
+    /* Number of register writes since the driver was created. The writes made in concurrent mode are not counted
+       (a counter shared by every thread would serialize them) */
+    uint32_t LedDriver_GetRegisterWriteCount( LedDriver self );
+
+    /* Deferred updates. Between LedDriver_BeginUpdate() and LedDriver_Flush() the operations only change
+       the driver's image (LedDriver_IsOn() reports the pending state), then the flush writes the registers
+       that changed in one go */
+    void LedDriver_BeginUpdate( LedDriver self );
+    void LedDriver_Flush( LedDriver self );
+
+    /* Concurrent mode. Several threads may then turn LEDs on/off (or apply masks) on the same driver:
+       the image is updated with atomic operations and the registers are republished until they match it,
+       so no update is lost and no mutex is needed. The operations are lock-free, not wait-free: a thread may retry
+       its register write while other threads keep changing the same register. Deferred updates are not available
+       in concurrent mode */
+    void LedDriver_SetConcurrent( LedDriver self, BOOL concurrent );
+
+    /* Tracing. Every change of the image is recorded into the trace (see LedTrace.h), NULL disables it */
+    void LedDriver_SetTrace( LedDriver self, LedTrace trace );
+
+    /* Instrumentation. The driver's hook (NULL disables it) is called every time its registers are updated:
+       once per LED, whole-bank or masked operation (even if no register ends up written), and once per
+       LedDriver_Flush() of a frame that changed something instead of once per operation deferred inside it */
+    typedef void ( *LedDriverUpdateHook )( void *context, LedDriver self );
+    void LedDriver_SetUpdateHook( LedDriver self, LedDriverUpdateHook hook, void *context );
 
 #endif
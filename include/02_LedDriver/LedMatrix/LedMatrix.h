@@ -0,0 +1,27 @@
+/**
+ * @file    LedMatrix.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Matrix module header file containing the prototype functions implemented by LedMatrix.c
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef LEDMATRIX_H
+#define LEDMATRIX_H
+
+    #include "LedDriver.h"
+
+    typedef struct LedMatrixStruct *LedMatrix; /* pointer type to a LedMatrixStruct */
+
+    /* Double-buffered framebuffer of a LED matrix whose rows are LedDriver banks (all of the same width).
+       Drawing (LedMatrix_SetPixel()/LedMatrix_Clear()) only changes the back buffer, LedMatrix_Flip() then
+       shows it by pushing the rows that changed since the previous flip. Rows and columns are numbered from 1 */
+    LedMatrix LedMatrix_Create( LedDriver *rows, int rowCount );
+    void LedMatrix_Destroy( LedMatrix self );
+    void LedMatrix_SetPixel( LedMatrix self, int row, uint16_t column, BOOL on );
+    BOOL LedMatrix_GetPixel( LedMatrix self, int row, uint16_t column );
+    void LedMatrix_Clear( LedMatrix self );
+    int LedMatrix_Flip( LedMatrix self );
+
+#endif
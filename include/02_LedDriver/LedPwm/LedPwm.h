@@ -0,0 +1,30 @@
+/**
+ * @file    LedPwm.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led PWM module header file containing the prototype functions implemented by LedPwm.c
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef LEDPWM_H
+#define LEDPWM_H
+
+    #include "LedDriver.h"
+
+    typedef struct LedPwmStruct *LedPwm; /* pointer type to a LedPwmStruct (one per LED bank) */
+
+    /* Software PWM (brightness control) for LED banks without a PWM peripheral.
+       Every LED gets an 8-bit brightness (0 = off, 255 = fully on) which is gamma corrected.
+       A PWM period lasts LEDPWM_TICKS_PER_PERIOD calls to LedPwm_Tick(), so a 1 kHz refresh needs
+       a tick of ~255 kHz (only 8 of those ticks write the LED image, the rest just count down).
+       A new brightness takes effect when the next period starts */
+    enum { LEDPWM_TICKS_PER_PERIOD = 255 };
+
+    LedPwm LedPwm_Create( LedDriver driver );
+    void LedPwm_Destroy( LedPwm self );
+    void LedPwm_SetBrightness( LedPwm self, uint16_t ledNumber, uint8_t brightness );
+    uint8_t LedPwm_GetBrightness( LedPwm self, uint16_t ledNumber );
+    void LedPwm_Tick( LedPwm self );
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file    LedRegisterPage.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Register Page module header file containing the prototype functions implemented by LedRegisterPage.c
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef LEDREGISTERPAGE_H
+#define LEDREGISTERPAGE_H
+
+    #include <stddef.h>
+
+    typedef struct LedRegisterPageStruct *LedRegisterPage; /* pointer type to a LedRegisterPageStruct */
+
+    /* A register page is the memory a LED driver writes its registers to (LedDriver_CreateBank( address, ... )).
+       Two targets are available:
+       - in-process memory
+       - a file mapped with mmap(), standing in for a memory-mapped register page on a Linux development box.
+         The writes can be observed by any other process that maps or reads the same file */
+    LedRegisterPage LedRegisterPage_CreateInMemory( size_t size );
+    LedRegisterPage LedRegisterPage_MapFile( const char *path, size_t size );
+    void LedRegisterPage_Destroy( LedRegisterPage self );
+    volatile void *LedRegisterPage_GetAddress( LedRegisterPage self );
+    void LedRegisterPage_Sync( LedRegisterPage self );
+
+#endif
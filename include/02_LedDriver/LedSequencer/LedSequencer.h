@@ -0,0 +1,31 @@
+/**
+ * @file    LedSequencer.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Sequencer module header file containing the prototype functions implemented by LedSequencer.c
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef LEDSEQUENCER_H
+#define LEDSEQUENCER_H
+
+    #include "LedDriver.h"
+
+    typedef struct LedSequencerStruct *LedSequencer; /* pointer type to a LedSequencerStruct (one per LED bank) */
+
+    /* Plays animations (blink patterns, status animations, ...) on a LED bank.
+       Producers define the frames once (a frame is a whole image of the bank, laid out like the masks of
+       LedDriver_Apply()) and then queue frames with the number of ticks each one has to be shown.
+       Every LedSequencer_Tick() costs the same no matter how complex the animation is: at most one
+       LedDriver_Apply() when a frame starts, nothing else otherwise */
+    enum { LEDSEQUENCER_MAX_FRAMES = 0x8000 }; /* the frame id shares a queue entry (int) with the ticks */
+
+    LedSequencer LedSequencer_Create( LedDriver driver, int frameCount, int queueCapacity );
+    void LedSequencer_Destroy( LedSequencer self );
+    void LedSequencer_DefineFrame( LedSequencer self, int frameId, const LedWord *image );
+    BOOL LedSequencer_Queue( LedSequencer self, int frameId, uint16_t ticks );
+    void LedSequencer_Tick( LedSequencer self );
+    BOOL LedSequencer_IsIdle( LedSequencer self );
+
+#endif
@@ -0,0 +1,42 @@
+/**
+ * @file    LedTrace.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Trace module header file containing the prototype functions implemented by LedTrace.c
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef LEDTRACE_H
+#define LEDTRACE_H
+
+    #include "LedDriver.h" /* LedWord / LedTrace */
+
+    /* one change of the LED image: which image word changed, from what to what, when and who asked for it */
+    typedef struct LedTraceEntry
+    {
+        uint64_t timestamp;  /* value returned by LedTrace_GetTimestamp() when the change was recorded */
+        const void *caller;  /* return address of the LedDriver call that made the change */
+        uint16_t word;       /* index of the image word that changed (LED 1 is bit 0 of word 0) */
+        LedWord oldImage;    /* image word before the change */
+        LedWord newImage;    /* image word after the change */
+        uint32_t sequence;   /* number of the record (1 for the first one), 0 if the entry was being written or
+                                was overwritten while it was read (the other fields are then meaningless) */
+    } LedTraceEntry;
+
+    /* A trace is a fixed-size ring that keeps the last 'capacity' changes (capacity must be a power of two).
+       Attach it to a driver with LedDriver_SetTrace().
+       Recording is lock-free, so threads sharing a driver in concurrent mode can record at the same time */
+    LedTrace LedTrace_Create( int capacity );
+    void LedTrace_Destroy( LedTrace self );
+    void LedTrace_Record( LedTrace self, uint16_t word, LedWord oldImage, LedWord newImage, const void *caller );
+    int LedTrace_GetCount( LedTrace self );
+    LedTraceEntry LedTrace_GetEntry( LedTrace self, int index );
+    void LedTrace_Dump( LedTrace self );
+
+    /* Time source of the trace: the CPU cycle counter (rdtsc / cntvct_el0) by default, in ticks rather than
+       nanoseconds, or coarse monotonic nanoseconds where there is none.
+       It is a function pointer so the tests (or a target with a better time source) can replace it */
+    extern uint64_t ( *LedTrace_GetTimestamp )( void );
+
+#endif
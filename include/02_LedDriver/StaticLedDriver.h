@@ -0,0 +1,168 @@
+/**
+ * @file    StaticLedDriver.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   C++ compile-time specialized front end of the Led Driver, for boards whose layout is fixed at build time.
+ *
+ *          The register type, the LED range and the polarity are template parameters:
+ *
+ *              StaticLedDriver< uint16_t, 1, 16 > leds( &ledsRegister );
+ *              StaticLedDriver< uint8_t, 1, 8, true > statusLeds( &statusRegister );  // active-low LEDs
+ *
+ *              leds.turnOn< 3 >();   // image |= 0x0004, then the register is written
+ *              leds.turnOff< 3 >();  // image &= ~0x0004, then the register is written
+ *
+ *          With a LED number known at compile time there is nothing left to compute at run time: the bounds
+ *          are checked by static_assert, the bit position is a constant and the polarity inversion is folded
+ *          into the register write. LED numbers only known at run time use the overloads taking a LED number,
+ *          which check the bounds like LedDriver.c does.
+ *
+ *          Notes:
+ *          - the C API (LedDriver.h) remains the one to use when the layout is only known at run time
+ *            (wide banks, several register widths, masks, concurrent mode, tracing)
+ *          - this header is C++14 or later (constexpr functions with several statements)
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef STATICLEDDRIVER_H
+#define STATICLEDDRIVER_H
+
+    #include <climits>
+    #include <type_traits>
+
+    extern "C"
+    {
+        /* includes for things with C linkage */
+        #include "RuntimeError.h"
+    }
+
+    template< typename Register, unsigned FirstLed, unsigned LastLed, bool ActiveLow = false >
+    class StaticLedDriver
+    {
+        static_assert( std::is_unsigned< Register >::value, "the register must be an unsigned integer type" );
+        static_assert( ( FirstLed >= 1 ) && ( FirstLed <= LastLed ), "the LEDs are numbered from 1 and the range can not be empty" );
+        static_assert( LastLed - FirstLed < sizeof( Register ) * CHAR_BIT, "all the LEDs must fit in the register" );
+
+    public:
+
+        /* all the LEDs are turned on after hardware initialization.
+           Turn them all off instead during the Led Driver software initialization */
+        explicit StaticLedDriver( volatile Register *address ) : address( address ), image( 0 )
+        {
+            updateHardware();
+        }
+
+        /* bit of the register that holds the LED (a constant) */
+        template< unsigned Led >
+        static constexpr Register bit()
+        {
+            static_assert( ( Led >= FirstLed ) && ( Led <= LastLed ), "out-of-bounds LED" );
+
+            return static_cast< Register >( Register( 1 ) << ( Led - FirstLed ) );
+        }
+
+        template< unsigned Led >
+        void turnOn()
+        {
+            image |= bit< Led >();
+            updateHardware();
+        }
+
+        template< unsigned Led >
+        void turnOff()
+        {
+            image &= static_cast< Register >( ~bit< Led >() );
+            updateHardware();
+        }
+
+        template< unsigned Led >
+        bool isOn() const
+        {
+            return ( image & bit< Led >() ) != 0;
+        }
+
+        void turnOn( unsigned ledNumber )
+        {
+            /* only turn on LEDs within the FirstLed-LastLed range */
+            if ( isLedInBounds( ledNumber ) )
+            {
+                image |= bitOf( ledNumber );
+                updateHardware();
+            }
+            else
+            {
+                RUNTIME_ERROR( "LED Driver: out-of-bounds LED", static_cast< int >( ledNumber ) );
+            }
+        }
+
+        void turnOff( unsigned ledNumber )
+        {
+            /* only turn off LEDs within the FirstLed-LastLed range */
+            if ( isLedInBounds( ledNumber ) )
+            {
+                image &= static_cast< Register >( ~bitOf( ledNumber ) );
+                updateHardware();
+            }
+        }
+
+        bool isOn( unsigned ledNumber ) const
+        {
+            /* out-of-bounds LEDs are always off */
+            return isLedInBounds( ledNumber ) && ( ( image & bitOf( ledNumber ) ) != 0 );
+        }
+
+        void turnAllOn()
+        {
+            image = allLeds();
+            updateHardware();
+        }
+
+        void turnAllOff()
+        {
+            image = 0;
+            updateHardware();
+        }
+
+        bool areAllOn() const
+        {
+            return image == allLeds();
+        }
+
+        bool areAllOff() const
+        {
+            return image == 0;
+        }
+
+    private:
+
+        /* bits of the register that belong to a LED */
+        static constexpr Register allLeds()
+        {
+            return ( LastLed - FirstLed + 1 == sizeof( Register ) * CHAR_BIT )
+                   ? static_cast< Register >( ~Register( 0 ) )
+                   : static_cast< Register >( ( Register( 1 ) << ( LastLed - FirstLed + 1 ) ) - 1 );
+        }
+
+        static constexpr bool isLedInBounds( unsigned ledNumber )
+        {
+            return ( ledNumber >= FirstLed ) && ( ledNumber <= LastLed );
+        }
+
+        static constexpr Register bitOf( unsigned ledNumber )
+        {
+            return static_cast< Register >( Register( 1 ) << ( ledNumber - FirstLed ) );
+        }
+
+        void updateHardware()
+        {
+            /* the image holds 1 for a LED that is on; active-low LEDs are on when their bit is 0,
+               which costs a single (compile-time selected) NOT on the way to the register */
+            *address = ActiveLow ? static_cast< Register >( ~image ) : image;
+        }
+
+        volatile Register *address; /* LEDs' register */
+        Register image;             /* LEDs' state, one bit per LED (1 = on, whatever the polarity) */
+    };
+
+#endif
@@ -17,14 +17,43 @@
         SUNDAY = 1, MONDAY, TUESDAY, WEDNESDAY, THURSDAY, FRIDAY, SATURDAY
     } Day;
 
-    enum { LS_OK, LS_TOO_MANY_EVENTS, LS_ID_OUT_OF_BOUNDS, LS_EVENT_DOES_NOT_EXIST };
-
-    void LightScheduler_Create( void );
-    void LightScheduler_Destroy( void );
-    int LightScheduler_ScheduleTurnOn( int id, Day day, int minuteOfDay );
-    int LightScheduler_ScheduleTurnOff( int id, Day day, int minuteOfDay );
-    int LightScheduler_ScheduleRemove( int id, Day day, int minuteOfDay );
-    void LightScheduler_Randomize( int id, Day day, int minuteOfDay );
-    void LightScheduler_WakeUp( void );
+    /* sets of days of the week, one bit per day (any combination of them is a valid set) */
+    typedef enum
+    {
+        DAYS_NONE      = 0x00,
+        DAYS_SUNDAY    = 0x01, DAYS_MONDAY = 0x02, DAYS_TUESDAY  = 0x04, DAYS_WEDNESDAY = 0x08,
+        DAYS_THURSDAY  = 0x10, DAYS_FRIDAY = 0x20, DAYS_SATURDAY = 0x40,
+        DAYS_WEEKDAY   = DAYS_MONDAY | DAYS_TUESDAY | DAYS_WEDNESDAY | DAYS_THURSDAY | DAYS_FRIDAY,
+        DAYS_WEEKEND   = DAYS_SATURDAY | DAYS_SUNDAY,
+        DAYS_EVERYDAY  = DAYS_WEEKDAY | DAYS_WEEKEND
+    } Days;
+
+    /* LS_BAD_ROW is reported by the bulk import (LightSchedulerImport.h) for a row that cannot be read */
+    enum { LS_OK, LS_TOO_MANY_EVENTS, LS_ID_OUT_OF_BOUNDS, LS_EVENT_DOES_NOT_EXIST, LS_TIME_OUT_OF_BOUNDS, LS_BAD_ROW };
+
+    enum { LS_DEFAULT_CATCH_UP_MINUTES = 15 };
+
+    enum { LS_NOTHING_DUE = -1 };
+
+    /* light scheduler type (a pointer to a light scheduler structure) */
+    typedef struct LightSchedulerStruct *LightScheduler;
+
+    LightScheduler LightScheduler_Create( void );
+    void LightScheduler_Destroy( LightScheduler self );
+    int LightScheduler_ScheduleTurnOn( LightScheduler self, int id, Day day, int minuteOfDay );
+    int LightScheduler_ScheduleTurnOff( LightScheduler self, int id, Day day, int minuteOfDay );
+    int LightScheduler_ScheduleRemove( LightScheduler self, int id, Day day, int minuteOfDay );
+    void LightScheduler_Randomize( LightScheduler self, int id, Day day, int minuteOfDay );
+    int LightScheduler_ScheduleTurnOnDays( LightScheduler self, int id, Days days, int minuteOfDay );
+    int LightScheduler_ScheduleTurnOffDays( LightScheduler self, int id, Days days, int minuteOfDay );
+    int LightScheduler_ScheduleRemoveDays( LightScheduler self, int id, Days days, int minuteOfDay );
+    void LightScheduler_RandomizeDays( LightScheduler self, int id, Days days, int minuteOfDay );
+    void LightScheduler_WakeUp( LightScheduler self );
+    void LightScheduler_SetCompiled( LightScheduler self, int enable );
+    void LightScheduler_SetCatchUpWindow( LightScheduler self, int minutes );
+    int LightScheduler_NextDue( LightScheduler self );
+    void LightScheduler_SetTickless( LightScheduler self, int enable );
+    void LightScheduler_BeginBatch( LightScheduler self );
+    void LightScheduler_EndBatch( LightScheduler self );
 
 #endif
@@ -0,0 +1,41 @@
+/**
+ * @file    LightSchedulerImport.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Light Scheduler Import module header file containing the prototype functions implemented by LightSchedulerImport.c
+ *
+ *          CSV files hold one event per line: "on" or "off", the light id, the days and the minute of the day, e.g.
+ *
+ *              on, 3, MONDAY|WEDNESDAY|FRIDAY, 1200
+ *              off, 3, EVERYDAY, 1380
+ *
+ *          The days are a Day name (SUNDAY to SATURDAY, EVERYDAY, WEEKDAY, WEEKEND) or several of them joined by '|'.
+ *          Empty lines and lines starting with '#' are skipped.
+ *
+ *          Binary files start with LS_IMPORT_MAGIC followed by one LS_IMPORT_RECORD_SIZE bytes record per event
+ *          (see LightSchedulerImport_EncodeRecord()).
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef LIGHTSCHEDULERIMPORT_H
+#define LIGHTSCHEDULERIMPORT_H
+
+    #include "LightScheduler.h"
+
+    #define LS_IMPORT_MAGIC "LSE1"
+
+    enum { LS_IMPORT_MAGIC_SIZE = 4, LS_IMPORT_RECORD_SIZE = 4 };
+
+    /* the file could not be imported at all (it cannot be opened, or it is not a binary schedule) */
+    enum { LS_IMPORT_FAILED = -1 };
+
+    /* called for every row that is not scheduled, with its row number (the first row is 1) and its status:
+       LS_BAD_ROW for a row that cannot be read, the status returned by the light scheduler otherwise */
+    typedef void ( *ImportErrorCallback )( void *context, long row, int status );
+
+    long LightSchedulerImport_Csv( LightScheduler scheduler, const char *path, ImportErrorCallback onError, void *context );
+    long LightSchedulerImport_Binary( LightScheduler scheduler, const char *path, ImportErrorCallback onError, void *context );
+    void LightSchedulerImport_EncodeRecord( int turnOn, int id, Days days, int minuteOfDay, unsigned char *record );
+
+#endif
@@ -16,7 +16,9 @@
         int dayOfWeek;
     } Time;
 
-    typedef void ( *WakeUpCallback )( void );
+    /* the alarm callback gets back the context it was registered with
+       (e.g. the light scheduler to wake up, when a process hosts many of them) */
+    typedef void ( *WakeUpCallback )( void *context );
 
     /* These are the function prototypes for the Time Service module production source code
        (TimeService.c). Because the Light Scheduler module (which depends on the Time Service module)
@@ -27,7 +29,9 @@
 
     void TimeService_Create( void );
     void TimeService_GetTime( Time *time );
-    void TimeService_SetPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb );
-    void TimeService_CancelPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb );
+    void TimeService_SetPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb, void *context );
+    void TimeService_CancelPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb, void *context );
+    void TimeService_SetOneShotAlarmInSeconds( int seconds, WakeUpCallback cb, void *context );
+    void TimeService_CancelOneShotAlarm( WakeUpCallback cb, void *context );
  
 #endif
@@ -0,0 +1,274 @@
+/**
+ * @file    AsyncCircularBuffer.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   C++20 coroutine wrapper around the Circular Buffer module (CircularBuffer.c).
+ *
+ *          Instead of polling CircularBuffer_Get() (or handing the buffer over to another thread),
+ *          a coroutine can simply write:
+ *
+ *              int value = co_await buffer.get();
+ *              co_await buffer.put( 42 );
+ *
+ *          get() suspends the coroutine while the circular buffer is empty and put() suspends it
+ *          while the circular buffer is full. A suspended coroutine is resumed by the opposite operation
+ *          (a put() resumes the oldest waiting get(), a get() resumes the oldest waiting put()),
+ *          so any number of consumers can wait on a buffer without needing a thread each.
+ *
+ *          A buffer of capacity 0 is a rendezvous: every put() waits for a get() (or the other way around)
+ *          and the value goes straight from one coroutine to the other.
+ *
+ *          Notes:
+ *          - this header is C++20 only (it needs <coroutine>), the C API in CircularBuffer.h is unchanged
+ *          - the wrapper is single-threaded: all the coroutines awaiting the same buffer must run on the same thread
+ *          - waiting coroutines are resumed from within the put()/get() that satisfied them, one after the other
+ *            (a coroutine woken up while another one is being resumed is queued, not resumed on top of it)
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef ASYNCCIRCULARBUFFER_H
+#define ASYNCCIRCULARBUFFER_H
+
+    #include <coroutine>
+
+    extern "C"
+    {
+        /* includes for things with C linkage */
+        #include "CircularBuffer.h"
+    }
+
+    class AsyncCircularBuffer
+    {
+    private:
+
+        /* a suspended coroutine, linked into a waiting list (or into the ready list once it can carry on) */
+        struct Waiter
+        {
+            std::coroutine_handle<> handle;
+            Waiter *next = nullptr;
+        };
+
+    public:
+
+        /* awaitable returned by get(), it lives in the frame of the awaiting coroutine while it is suspended,
+           so the waiting list below can link the awaiters together without any allocation */
+        class GetAwaiter : private Waiter
+        {
+        public:
+
+            explicit GetAwaiter( AsyncCircularBuffer &owner ) : owner( owner ) {}
+
+            bool await_ready() const
+            {
+                /* the buffer is only touched once the coroutine has reached await_suspend() */
+                return false;
+            }
+
+            bool await_suspend( std::coroutine_handle<> h )
+            {
+                /* if the circular buffer has a value, there's no reason to suspend */
+                if ( !CircularBuffer_IsEmpty( owner.buffer ) )
+                {
+                    /* read the oldest value ... */
+                    value = CircularBuffer_Get( owner.buffer );
+
+                    /* ... which frees a slot for the oldest coroutine waiting to put a value (if any) */
+                    owner.readyWaitingPut();
+                    owner.resumeReady();
+
+                    return false;
+                }
+
+                /* the buffer is empty but a coroutine may still be waiting to put a value
+                   (a buffer of capacity 0 is always full), take the value straight from it */
+                if ( owner.takeWaitingPut( value ) )
+                {
+                    owner.resumeReady();
+
+                    return false;
+                }
+
+                /* otherwise suspend until a put() hands a value over */
+                handle = h;
+                owner.getters.push( this );
+
+                return true;
+            }
+
+            int await_resume() const
+            {
+                return value;
+            }
+
+        private:
+
+            friend class AsyncCircularBuffer;
+
+            AsyncCircularBuffer &owner;
+            int value = 0; /* value read (or handed over by a put()) */
+        };
+
+        /* awaitable returned by put(), same idea as GetAwaiter but waiting for a free slot */
+        class PutAwaiter : private Waiter
+        {
+        public:
+
+            PutAwaiter( AsyncCircularBuffer &owner, int value ) : owner( owner ), value( value ) {}
+
+            bool await_ready() const
+            {
+                /* the buffer is only touched once the coroutine has reached await_suspend() */
+                return false;
+            }
+
+            bool await_suspend( std::coroutine_handle<> h )
+            {
+                /* a coroutine waiting in get() means the circular buffer is empty,
+                   so hand the value straight to it instead of going through the circular buffer */
+                if ( Waiter *waiter = owner.getters.pop() )
+                {
+                    static_cast< GetAwaiter * >( waiter )->value = value;
+                    owner.ready.push( waiter );
+                    owner.resumeReady();
+
+                    return false;
+                }
+
+                /* if there's room for the value, there's no reason to suspend */
+                if ( !CircularBuffer_IsFull( owner.buffer ) )
+                {
+                    CircularBuffer_Put( owner.buffer, value );
+
+                    return false;
+                }
+
+                /* otherwise suspend until a get() frees a slot */
+                handle = h;
+                owner.putters.push( this );
+
+                return true;
+            }
+
+            void await_resume() const
+            {
+            }
+
+        private:
+
+            friend class AsyncCircularBuffer;
+
+            AsyncCircularBuffer &owner;
+            int value; /* value to insert into the circular buffer */
+        };
+
+        explicit AsyncCircularBuffer( int capacity ) : buffer( CircularBuffer_Create( capacity ) ) {}
+
+        ~AsyncCircularBuffer()
+        {
+            CircularBuffer_Destroy( buffer );
+        }
+
+        AsyncCircularBuffer( const AsyncCircularBuffer & ) = delete;
+        AsyncCircularBuffer &operator=( const AsyncCircularBuffer & ) = delete;
+
+        GetAwaiter get()
+        {
+            return GetAwaiter( *this );
+        }
+
+        PutAwaiter put( int value )
+        {
+            return PutAwaiter( *this, value );
+        }
+
+        /* access to the wrapped circular buffer, e.g. for CircularBuffer_Print() */
+        CircularBuffer circularBuffer() const
+        {
+            return buffer;
+        }
+
+    private:
+
+        /* FIFO list of suspended coroutines, linked through their 'next' member */
+        struct WaitingList
+        {
+            Waiter *head = nullptr;
+            Waiter *tail = nullptr;
+
+            void push( Waiter *waiter )
+            {
+                waiter->next = nullptr;
+                ( tail ? tail->next : head ) = waiter;
+                tail = waiter;
+            }
+
+            Waiter *pop()
+            {
+                Waiter *waiter = head;
+
+                if ( waiter )
+                {
+                    head = waiter->next;
+
+                    if ( !head )
+                    {
+                        tail = nullptr;
+                    }
+                }
+
+                return waiter;
+            }
+        };
+
+        void readyWaitingPut()
+        {
+            /* a coroutine waiting in put() means the circular buffer was full,
+               a slot has just been freed, so store its value and let it carry on */
+            if ( Waiter *waiter = putters.pop() )
+            {
+                CircularBuffer_Put( buffer, static_cast< PutAwaiter * >( waiter )->value );
+                ready.push( waiter );
+            }
+        }
+
+        bool takeWaitingPut( int &value )
+        {
+            /* the oldest coroutine waiting in put() hands its value over and carries on */
+            if ( Waiter *waiter = putters.pop() )
+            {
+                value = static_cast< PutAwaiter * >( waiter )->value;
+                ready.push( waiter );
+
+                return true;
+            }
+
+            return false;
+        }
+
+        void resumeReady()
+        {
+            /* a coroutine resumed below that wakes up another one only queues it: the loop of the
+               outermost put()/get() resumes it once the first one suspends again, so a long chain of
+               hand-offs runs one coroutine after the other instead of nesting their stack frames */
+            if ( resuming )
+                return;
+
+            resuming = true;
+
+            while ( Waiter *waiter = ready.pop() )
+            {
+                waiter->handle.resume();
+            }
+
+            resuming = false;
+        }
+
+        CircularBuffer buffer;
+        WaitingList getters;    /* coroutines waiting for a value */
+        WaitingList putters;    /* coroutines waiting for a free slot */
+        WaitingList ready;      /* coroutines that can carry on, waiting to be resumed */
+        bool resuming = false;  /* TRUE while resumeReady() is resuming the ready coroutines */
+    };
+
+#endif
@@ -7,8 +7,8 @@
  * @date    2025-04-22
  */
 
-#ifndef LIGHTCONTROLLER_H
-#define LIGHTCONTROLLER_H
+#ifndef CIRCULARBUFFER_H
+#define CIRCULARBUFFER_H
 
     typedef struct CircularBufferStruct *CircularBuffer; /* pointer type to a CircularBufferStruct */
 
@@ -16,6 +16,8 @@
     void CircularBuffer_Destroy( CircularBuffer self );
     int CircularBuffer_Put( CircularBuffer self, int value );
     int CircularBuffer_Get( CircularBuffer self );
+    int CircularBuffer_IsEmpty( CircularBuffer self );
+    int CircularBuffer_IsFull( CircularBuffer self );
     void CircularBuffer_Print( CircularBuffer self );
 
 #endif
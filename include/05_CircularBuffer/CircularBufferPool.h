@@ -0,0 +1,22 @@
+/**
+ * @file    CircularBufferPool.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Circular Buffer Pool module header file containing the prototype functions implemented by CircularBufferPool.c
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef CIRCULARBUFFERPOOL_H
+#define CIRCULARBUFFERPOOL_H
+
+    #include "CircularBuffer.h"
+
+    typedef struct CircularBufferPoolStruct *CircularBufferPool; /* pointer type to a CircularBufferPoolStruct */
+
+    CircularBufferPool CircularBufferPool_Create( const int *capacities, int classCount, int buffersPerSlab );
+    void CircularBufferPool_Destroy( CircularBufferPool self );
+    CircularBuffer CircularBufferPool_Acquire( CircularBufferPool self, int capacity );
+    void CircularBufferPool_Release( CircularBufferPool self, CircularBuffer buffer );
+
+#endif
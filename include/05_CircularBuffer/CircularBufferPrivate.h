@@ -0,0 +1,33 @@
+/**
+ * @file    CircularBufferPrivate.h
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Circular Buffer module private header file.
+ *
+ *          Application code only sees the CircularBuffer pointer type from CircularBuffer.h.
+ *          The structure layout is shared here only with the modules that have to place circular buffers
+ *          in memory they manage themselves (i.e. CircularBufferPool.c), so do not include it anywhere else.
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#ifndef CIRCULARBUFFERPRIVATE_H
+#define CIRCULARBUFFERPRIVATE_H
+
+    #include "CircularBuffer.h"
+
+    /* structure data type to hold a circular buffer that stores integer values */
+    typedef struct CircularBufferStruct
+    {
+        int count;    /* number of elements currently stored in the circular buffer (maximum value is limited by 'capacity') */
+        int index;    /* "pointer" to the next location to store a value in the circular buffer */
+        int outdex;   /* "pointer" to the next location to read a value from the circular buffer */
+        int capacity; /* circular buffer capacity (i.e. number of elements it can store) */
+        int *values;  /* array/elements of the circular buffer */
+    } CircularBufferStruct;
+
+    /* initializes an (already allocated) empty circular buffer that stores its values in 'values',
+       an array that must be able to hold capacity + 1 integers (the extra one is the buffer guard) */
+    void CircularBuffer_Init( CircularBuffer self, int *values, int capacity );
+
+#endif
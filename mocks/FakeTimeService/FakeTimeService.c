@@ -38,13 +38,20 @@ static Time fakeTime;
 /* pointer to the time service callback function */
 static WakeUpCallback callback;
 
+/* context handed back to the callback function */
+static void *context;
+
 /* period set for the alarm callback */
 static int period;
 
+/* delay set for the one-shot alarm callback (TIME_UNKNOWN when no one-shot alarm is armed) */
+static int delay = TIME_UNKNOWN;
+
 void TimeService_Create( void )
 {
     fakeTime.minuteOfDay = TIME_UNKNOWN;
     fakeTime.dayOfWeek   = TIME_UNKNOWN;
+    delay                = TIME_UNKNOWN;
 }
 
 /* Function that controls the information returned to the CUT during the Fake's mission.
@@ -66,9 +73,10 @@ void TimeService_GetTime( Time *time )
    
    Here, we use a test double for TimeService_SetPeriodicAlarmInSeconds(), which (originally implemented in TimeService.c)
    is substituted during link-time (so that it uses the test version from FakeTimeService.c instead) */
-void TimeService_SetPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb )
+void TimeService_SetPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb, void *cbContext )
 {
     callback = cb;
+    context  = cbContext;
     period   = seconds;
 }
 
@@ -79,17 +87,51 @@ void TimeService_SetPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb )
    
    Here, we use a test double for TimeService_CancelPeriodicAlarmInSeconds(), which (originally implemented in TimeService.c)
    is substituted during link-time (so that it uses the test version from FakeTimeService.c instead) */
-void TimeService_CancelPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb )
+void TimeService_CancelPeriodicAlarmInSeconds( int seconds, WakeUpCallback cb, void *cbContext )
 {
     /* if the specified alarm is set */
-    if ( ( cb == callback ) && ( period == seconds ) )
+    if ( ( cb == callback ) && ( cbContext == context ) && ( period == seconds ) )
     {
         /* "destroy" it */
         callback = NULL;
+        context  = NULL;
         period   = 0;
     }
 }
 
+/* Function that controls the information returned to the CUT during the Fake's mission.
+   This information is controlled through the interface (TimeService_SetOneShotAlarmInSeconds())
+   of the replaced collaborator (Time Service). The fake simply saves the function pointer and its delay
+   and reports it on demand (a one-shot alarm replaces the alarm previously armed).
+   
+   Here, we use a test double for TimeService_SetOneShotAlarmInSeconds(), which (originally implemented in TimeService.c)
+   is substituted during link-time (so that it uses the test version from FakeTimeService.c instead) */
+void TimeService_SetOneShotAlarmInSeconds( int seconds, WakeUpCallback cb, void *cbContext )
+{
+    callback = cb;
+    context  = cbContext;
+    delay    = seconds;
+}
+
+/* Function that controls the information returned to the CUT during the Fake's mission.
+   This information is controlled through the interface (TimeService_CancelOneShotAlarm())
+   of the replaced collaborator (Time Service). The fake simply resets the function pointer and its delay
+   and reports it on demand.
+   
+   Here, we use a test double for TimeService_CancelOneShotAlarm(), which (originally implemented in TimeService.c)
+   is substituted during link-time (so that it uses the test version from FakeTimeService.c instead) */
+void TimeService_CancelOneShotAlarm( WakeUpCallback cb, void *cbContext )
+{
+    /* if the specified alarm is armed */
+    if ( ( cb == callback ) && ( cbContext == context ) && ( delay != TIME_UNKNOWN ) )
+    {
+        /* "destroy" it */
+        callback = NULL;
+        context  = NULL;
+        delay    = TIME_UNKNOWN;
+    }
+}
+
 /* As explained in the description of this file, time is a volatile input that makes testing a challenge.
    Waiting for timed events takes too long. Here this interface takes over the clock making it possible 
    to set a specific minute of the day */
@@ -113,9 +155,23 @@ WakeUpCallback FakeTimeService_GetAlarmCallback( void )
     return callback;
 }
 
+/* this fake function returns the context registered along with the alarm callback function via
+   TimeService_SetPeriodicAlarminSeconds() which is called inside LightScheduler_Create() */
+void *FakeTimeService_GetAlarmContext( void )
+{
+    return context;
+}
+
 /* this fake function returns the alarm callback period registered via
    TimeService_SetPeriodicAlarminSeconds() which is called inside LightScheduler_Create() */
 int FakeTimeSource_GetAlarmPeriodInSeconds( void )
 {
     return period;
 }
+
+/* this fake function returns the delay of the one-shot alarm armed via
+   TimeService_SetOneShotAlarmInSeconds() by a tickless light scheduler (TIME_UNKNOWN when none is armed) */
+int FakeTimeService_GetOneShotAlarmInSeconds( void )
+{
+    return delay;
+}
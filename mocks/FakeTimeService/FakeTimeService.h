@@ -23,6 +23,8 @@
     void FakeTimeService_SetMinute( int minute );
     void FakeTimeService_SetDay( int day );
     WakeUpCallback FakeTimeService_GetAlarmCallback( void );
+    void *FakeTimeService_GetAlarmContext( void );
     int FakeTimeSource_GetAlarmPeriodInSeconds( void );
+    int FakeTimeService_GetOneShotAlarmInSeconds( void );
 
 #endif
@@ -2,79 +2,494 @@
  * @file    LedDriver.c
  * @author  Julio Cesar Bernal Mendez
  * @brief   Led Driver source file that implements the functions for the LedDriver module.
- * 
+ *
+ *          A LED bank is made of 'ledCount' LEDs (numbered 1 through ledCount) placed behind consecutive
+ *          8, 16, 32 or 64-bit registers, LED 1 being bit 0 of the first register.
+ *          The LEDs' state (image) is stored as an array of LedWord (machine words), so:
+ *          - single LED operations only touch one word of the image and one register of the hardware
+ *          - whole-bank operations and queries run one word at a time
+ *          - masked operations (LedDriver_SetMask/ClearMask/Apply) change any number of LEDs
+ *            with a single hardware update
+ *          - a register is only written when its LEDs' state differs from the value last written to it,
+ *            and LedDriver_BeginUpdate()/LedDriver_Flush() collapse all the changes in between into one update
+ *          - in concurrent mode (LedDriver_SetConcurrent()) several threads can share a driver: the image is
+ *            changed with atomic fetch-or/fetch-and and every register is republished until it matches the image
+ *          - with a trace attached (LedDriver_SetTrace()) every change of an image word is recorded, together with
+ *            the caller of the LedDriver function that made it, and the trace is dumped before a runtime error
+ *
  * @version 0.1
  * @date    2025-02-27
  */
 
 #include "LedDriver.h"
+#include "LedTrace.h"
 #include "RuntimeError.h"
+#include <stdlib.h>
+#include <string.h> /* memset() */
 
 enum { ALL_LEDS_ON = ~0, ALL_LEDS_OFF = ~ALL_LEDS_ON };
-enum { FIRST_LED = 1, LAST_LED = 16 };
+enum { FIRST_LED = 1, LAST_LED = 16 }; /* LEDs of a board created with LedDriver_Create() */
 
-/* LED's address */
-static uint16_t *ledsAddress;
+/* address the public function that changes the image returns to, recorded as the caller of the change */
+#define CALLER()    __builtin_return_address( 0 )
 
-/* LED's state */
-static uint16_t ledsImage;
+/* structure data type to hold the state of one LED bank.
+   The image words (followed by the last written words) are stored right after the structure
+   (same block of memory, see LedDriver_SizeOf()) */
+typedef struct LedDriverStruct
+{
+    volatile void *ledsAddress; /* LED's address (first register of the bank) */
+    uint16_t ledCount;          /* number of LEDs in the bank */
+    uint16_t wordCount;         /* number of LedWord in the image */
+    uint8_t registerBits;       /* width of every register (8, 16, 32 or 64 bits) */
+    uint8_t updateDepth;        /* number of LedDriver_BeginUpdate() calls not yet flushed */
+    BOOL dirty;                 /* the image changed while the hardware updates were deferred */
+    BOOL concurrent;            /* several threads share the driver, the image is updated atomically */
+    LedTrace trace;             /* records the image changes (NULL when tracing is disabled) */
+    LedDriverUpdateHook hook;   /* called on every hardware update (NULL when not instrumented) */
+    void *hookContext;          /* passed back to the hook */
+    uint32_t registerWrites;    /* number of register writes since the driver was created (not in concurrent mode) */
+    LedWord *lastWritten;       /* value last written to every register, laid out like the image */
+    LedWord ledsImage[];        /* LED's state, one bit per LED */
+} LedDriverStruct;
+
+static int wordIndexOf( uint16_t ledNumber )
+{
+    /* LEDs 1 through LED_WORD_BITS are stored in word 0, and so on */
+    return ( ledNumber - 1 ) / LED_WORD_BITS;
+}
+
+static LedWord convertLedNumberToBit( uint16_t ledNumber )
+{
+    /* The offset (-1) is needed because the LEDs are numbered from 1,
+       so LED 1 is bit 0 of word 0, and LED 16 is bit 15 of word 0 */
+    return ( ( LedWord ) 1 << ( ( ledNumber - 1 ) % LED_WORD_BITS ) );
+}
+
+static LedWord lastWordMask( LedDriver self )
+{
+    /* bits of the last image word that belong to an actual LED */
+    int usedBits = self->ledCount - ( self->wordCount - 1 ) * LED_WORD_BITS;
+
+    return ( usedBits == LED_WORD_BITS ) ? ( LedWord ) ALL_LEDS_ON : ( ( LedWord ) 1 << usedBits ) - 1;
+}
+
+static LedWord registerMask( LedDriver self, int reg )
+{
+    /* bits of the image word that belong to the register */
+    LedWord mask = ( self->registerBits == LED_WORD_BITS ) ? ( LedWord ) ALL_LEDS_ON
+                                                           : ( ( LedWord ) 1 << self->registerBits ) - 1;
+
+    return mask << ( ( reg * self->registerBits ) % LED_WORD_BITS );
+}
 
-static void updateHardware( void )
+static void writeRegister( LedDriver self, int reg )
 {
-    /* set the LEDs' state */
-    *ledsAddress = ledsImage;
+    /* position of the register's first bit within the image */
+    int firstBit = reg * self->registerBits;
+    int word     = firstBit / LED_WORD_BITS;
+    LedWord mask = registerMask( self, reg );
+
+    /* the register is a slice of one image word (registers never straddle two words) */
+    LedWord value = self->ledsImage[ word ] >> ( firstBit % LED_WORD_BITS );
+
+    /* remember what the register holds from now on */
+    self->lastWritten[ word ] = ( self->lastWritten[ word ] & ~mask ) | ( self->ledsImage[ word ] & mask );
+
+    /* keep track of the register writes, they are the expensive part of every operation */
+    self->registerWrites++;
+
+    /* set the LEDs' state (the cast drops the bits that belong to the next registers).
+       The registers are accessed through volatile pointers, so the compiler can neither drop
+       nor reorder the writes: every write reaches the register (or the mapped page standing in for it)
+       in program order */
+    switch ( self->registerBits )
+    {
+        case 8:  ( ( volatile uint8_t * )  self->ledsAddress )[ reg ] = ( uint8_t )  value; break;
+        case 16: ( ( volatile uint16_t * ) self->ledsAddress )[ reg ] = ( uint16_t ) value; break;
+        case 32: ( ( volatile uint32_t * ) self->ledsAddress )[ reg ] = ( uint32_t ) value; break;
+        default: ( ( volatile uint64_t * ) self->ledsAddress )[ reg ] = ( uint64_t ) value; break;
+    }
 }
 
-static uint16_t convertLedNumberToBit( uint16_t ledNumber )
+static void publishRegister( LedDriver self, int reg )
 {
-    /* The offset (-1) is needed because the LEDs are numbered 1 through 16,
-       so LED 1 is bit 0, and LED 16 is bit 15 */
-    return ( 1 << ( ledNumber - 1 ) );
+    /* position of the register's first bit within the image */
+    int firstBit = reg * self->registerBits;
+    int word     = firstBit / LED_WORD_BITS;
+    LedWord seen;
+
+    /* Concurrent mode: another thread may change the image while this one writes the register, so the
+       register is written again until the image word stays the same across the write. Whichever thread
+       publishes last has seen every change made before it, so the last writer always leaves the register
+       in sync with the image (no lock, and no shadow copy to keep consistent).
+
+       Ordering: the register store, the re-check of the image and the image changes (orImageWord() and the others)
+       are all sequentially consistent. Release/acquire would let the re-check load move ahead of the register store
+       (store-load reordering, allowed even on x86): this thread could see no change while its stale value is still
+       on its way, land after the value of the thread that made the change, and leave the register out of sync.
+       In the single total order of seq_cst operations, a re-check that misses another thread's change comes before
+       that change, so this thread's register store comes before the other thread's one, which wins.
+
+       Progress: the loop is not bounded. A retry only happens after another thread completed a change of
+       this register's bits, and publishing never changes the image, so some thread always gets its operation
+       through (lock-free), but one thread can keep retrying for as long as the others keep changing the same
+       register (not wait-free). The retry cannot be dropped in favour of the thread that made the change:
+       that thread may have published before this thread's stale value landed, and no one would correct it */
+    do
+    {
+        seen = __atomic_load_n( &self->ledsImage[ word ], __ATOMIC_SEQ_CST );
+
+        switch ( self->registerBits )
+        {
+            case 8:  __atomic_store_n( &( ( volatile uint8_t * )  self->ledsAddress )[ reg ],
+                                       ( uint8_t )  ( seen >> ( firstBit % LED_WORD_BITS ) ), __ATOMIC_SEQ_CST ); break;
+            case 16: __atomic_store_n( &( ( volatile uint16_t * ) self->ledsAddress )[ reg ],
+                                       ( uint16_t ) ( seen >> ( firstBit % LED_WORD_BITS ) ), __ATOMIC_SEQ_CST ); break;
+            case 32: __atomic_store_n( &( ( volatile uint32_t * ) self->ledsAddress )[ reg ],
+                                       ( uint32_t ) ( seen >> ( firstBit % LED_WORD_BITS ) ), __ATOMIC_SEQ_CST ); break;
+            default: __atomic_store_n( &( ( volatile uint64_t * ) self->ledsAddress )[ reg ],
+                                       ( uint64_t ) ( seen >> ( firstBit % LED_WORD_BITS ) ), __ATOMIC_SEQ_CST ); break;
+        }
+
+        /* no register write count here: a counter shared by all the threads would serialize them */
+    }
+    while ( ( ( __atomic_load_n( &self->ledsImage[ word ], __ATOMIC_SEQ_CST ) ^ seen ) & registerMask( self, reg ) ) != 0 );
 }
 
-static BOOL IsLedInOfBounds( uint16_t ledNumber )
+static int registerCountOf( LedDriver self )
+{
+    return ( self->ledCount + self->registerBits - 1 ) / self->registerBits;
+}
+
+static void updateRegister( LedDriver self, int reg )
+{
+    int word = ( reg * self->registerBits ) / LED_WORD_BITS;
+
+    /* writing the value the register already holds would be a wasted bus cycle */
+    if ( ( ( self->ledsImage[ word ] ^ self->lastWritten[ word ] ) & registerMask( self, reg ) ) != 0 )
+    {
+        writeRegister( self, reg );
+    }
+}
+
+static BOOL deferHardwareUpdate( LedDriver self )
+{
+    /* inside a LedDriver_BeginUpdate()/LedDriver_Flush() frame the registers are written at the end only */
+    if ( self->updateDepth > 0 )
+    {
+        self->dirty = TRUE;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void notifyHardwareUpdate( LedDriver self )
+{
+    /* the registers are about to be updated (deferred operations never get here, their flush does) */
+    if ( self->hook != NULL )
+    {
+        self->hook( self->hookContext, self );
+    }
+}
+
+static void updateRegisters( LedDriver self )
+{
+    int reg; /* register index */
+    int registerCount = registerCountOf( self );
+
+    notifyHardwareUpdate( self );
+
+    /* set the state of the whole bank (only the registers that changed) */
+    for ( reg = 0; reg < registerCount; reg++ )
+    {
+        updateRegister( self, reg );
+    }
+}
+
+static void updateHardware( LedDriver self )
+{
+    int reg; /* register index */
+    int registerCount = registerCountOf( self );
+
+    /* concurrent mode: publish every register (threads never defer nor skip writes) */
+    if ( self->concurrent )
+    {
+        notifyHardwareUpdate( self );
+
+        for ( reg = 0; reg < registerCount; reg++ )
+        {
+            publishRegister( self, reg );
+        }
+
+        return;
+    }
+
+    if ( deferHardwareUpdate( self ) )
+    {
+        return;
+    }
+
+    updateRegisters( self );
+}
+
+static void updateHardwareLed( LedDriver self, uint16_t ledNumber )
+{
+    /* concurrent mode: publish the only register that holds the LED */
+    if ( self->concurrent )
+    {
+        notifyHardwareUpdate( self );
+        publishRegister( self, ( ledNumber - 1 ) / self->registerBits );
+        return;
+    }
+
+    if ( deferHardwareUpdate( self ) )
+    {
+        return;
+    }
+
+    /* set the state of the only register that holds the LED */
+    notifyHardwareUpdate( self );
+    updateRegister( self, ( ledNumber - 1 ) / self->registerBits );
+}
+
+static BOOL IsLedInOfBounds( LedDriver self, uint16_t ledNumber )
 {
     /* return TRUE if LED is within the valid range, return FALSE otherwise */
-    return ( ( ledNumber >= FIRST_LED ) && ( ledNumber <= LAST_LED ) );
+    return ( ( ledNumber >= FIRST_LED ) && ( ledNumber <= self->ledCount ) );
+}
+
+static LedWord wordMask( LedDriver self, int i )
+{
+    /* bits of image word 'i' that belong to an actual LED (bits beyond the last LED are always kept off) */
+    return ( i == self->wordCount - 1 ) ? lastWordMask( self ) : ( LedWord ) ALL_LEDS_ON;
+}
+
+static LedWord loadImageWord( LedDriver self, int i )
+{
+    return self->concurrent ? __atomic_load_n( &self->ledsImage[ i ], __ATOMIC_ACQUIRE ) : self->ledsImage[ i ];
+}
+
+static void traceImageWord( LedDriver self, int i, LedWord oldWord, LedWord newWord, const void *caller )
+{
+    /* only the words that actually changed are recorded */
+    if ( ( self->trace != NULL ) && ( oldWord != newWord ) )
+    {
+        LedTrace_Record( self->trace, i, oldWord, newWord, caller );
+    }
+}
+
+static void orImageWord( LedDriver self, int i, LedWord bits, const void *caller )
+{
+    LedWord oldWord;
+
+    /* a plain read-modify-write loses the changes other threads make in between, fetch-or does not */
+    if ( self->concurrent )
+    {
+        oldWord = __atomic_fetch_or( &self->ledsImage[ i ], bits, __ATOMIC_SEQ_CST );
+    }
+    else
+    {
+        oldWord = self->ledsImage[ i ];
+        self->ledsImage[ i ] = oldWord | bits;
+    }
+
+    traceImageWord( self, i, oldWord, oldWord | bits, caller );
 }
 
-static void setLedImageBit( uint16_t ledNumber )
+static void andImageWord( LedDriver self, int i, LedWord bits, const void *caller )
+{
+    LedWord oldWord;
+
+    if ( self->concurrent )
+    {
+        oldWord = __atomic_fetch_and( &self->ledsImage[ i ], bits, __ATOMIC_SEQ_CST );
+    }
+    else
+    {
+        oldWord = self->ledsImage[ i ];
+        self->ledsImage[ i ] = oldWord & bits;
+    }
+
+    traceImageWord( self, i, oldWord, oldWord & bits, caller );
+}
+
+static void applyImageWord( LedDriver self, int i, LedWord on, LedWord off, const void *caller )
+{
+    LedWord oldWord; /* image word the new value is computed from */
+
+    if ( self->concurrent )
+    {
+        /* both masks have to land at once, retry if another thread changed the word in between */
+        oldWord = __atomic_load_n( &self->ledsImage[ i ], __ATOMIC_RELAXED );
+
+        while ( !__atomic_compare_exchange_n( &self->ledsImage[ i ], &oldWord, ( oldWord & ~off ) | on,
+                                              1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED ) )
+        {
+        }
+    }
+    else
+    {
+        oldWord = self->ledsImage[ i ];
+        self->ledsImage[ i ] = ( oldWord & ~off ) | on;
+    }
+
+    traceImageWord( self, i, oldWord, ( oldWord & ~off ) | on, caller );
+}
+
+static void storeImageWord( LedDriver self, int i, LedWord word, const void *caller )
+{
+    LedWord oldWord;
+
+    if ( self->concurrent )
+    {
+        oldWord = __atomic_exchange_n( &self->ledsImage[ i ], word, __ATOMIC_SEQ_CST );
+    }
+    else
+    {
+        oldWord = self->ledsImage[ i ];
+        self->ledsImage[ i ] = word;
+    }
+
+    traceImageWord( self, i, oldWord, word, caller );
+}
+
+static void setLedImageBit( LedDriver self, uint16_t ledNumber, const void *caller )
 {
     /* update the LEDs' state */
-    ledsImage |= convertLedNumberToBit( ledNumber );
+    orImageWord( self, wordIndexOf( ledNumber ), convertLedNumberToBit( ledNumber ), caller );
 }
 
-static void clearLedImageBit( uint16_t ledNumber )
+static void clearLedImageBit( LedDriver self, uint16_t ledNumber, const void *caller )
 {
     /* update the LEDs' state */
-    ledsImage &= ~convertLedNumberToBit( ledNumber );
+    andImageWord( self, wordIndexOf( ledNumber ), ~convertLedNumberToBit( ledNumber ), caller );
+}
+
+static void setImage( LedDriver self, LedWord word, const void *caller )
+{
+    int i; /* image word index */
+
+    /* store the LEDs' state one word at a time */
+    for ( i = 0; i < self->wordCount; i++ )
+    {
+        storeImageWord( self, i, word & wordMask( self, i ), caller );
+    }
+}
+
+LedDriver LedDriver_Create( uint16_t *address )
+{
+    /* a board of 16 LEDs behind a single 16-bit register */
+    return LedDriver_CreateBank( address, LAST_LED, 16 );
+}
+
+LedDriver LedDriver_CreateBank( volatile void *address, uint16_t ledCount, int registerBits )
+{
+    /* Allocate (dynamically) a block of memory to store the driver of one LED bank,
+       its image and the values last written to the registers */
+    void *storage = calloc( 1, LedDriver_SizeOf( ledCount ) );
+    LedDriver self;
+
+    /* LedDriver_Init() would clear memory that is not there */
+    if ( storage == NULL )
+    {
+        RUNTIME_ERROR( "LED Driver: out of memory", ledCount );
+        return NULL;
+    }
+
+    self = LedDriver_Init( storage, address, ledCount, registerBits );
+
+    /* the bank was rejected, nothing to keep */
+    if ( self == NULL )
+    {
+        free( storage );
+    }
+
+    /* return the address of the recently allocated LED driver */
+    return self;
+}
+
+size_t LedDriver_SizeOf( uint16_t ledCount )
+{
+    size_t wordCount = ( ledCount + LED_WORD_BITS - 1 ) / LED_WORD_BITS;
+
+    /* the structure, the image and the last written words, every image word is already aligned
+       (the structure ends with a LedWord array), so drivers stored one after the other stay aligned too */
+    return sizeof( LedDriverStruct ) + 2 * wordCount * sizeof( LedWord );
 }
 
-void LedDriver_Create( uint16_t *address )
+LedDriver LedDriver_Init( void *storage, volatile void *address, uint16_t ledCount, int registerBits )
 {
     /* all the LEDs are turned on after hardware initialization.
        Turn them all off instead during the Led Driver software initialization.
        This is a Led Driver requirement */
 
-    ledsAddress  = address;      /* assign the LEDs' address */
-    ledsImage    = ALL_LEDS_OFF; /* store the LEDs' state */
-    updateHardware();            /* set the LEDs' state */
+    LedDriver self = storage;
+    int reg; /* register index */
+    int wordCount = ( ledCount + LED_WORD_BITS - 1 ) / LED_WORD_BITS;
+
+    /* only registers that evenly split an image word are supported */
+    if ( ( ( registerBits != 8 ) && ( registerBits != 16 ) && ( registerBits != 32 ) && ( registerBits != 64 ) )
+      || ( registerBits > LED_WORD_BITS ) )
+    {
+        RUNTIME_ERROR( "LED Driver: unsupported register width", registerBits );
+        return NULL;
+    }
+
+    /* a bank needs at least one LED */
+    if ( ledCount < FIRST_LED )
+    {
+        RUNTIME_ERROR( "LED Driver: empty LED bank", ledCount );
+        return NULL;
+    }
+
+    /* the storage (LedDriver_SizeOf( ledCount ) bytes) may hold anything, start from a clean driver */
+    memset( self, 0, LedDriver_SizeOf( ledCount ) );
+
+    self->ledsAddress  = address;      /* assign the LEDs' address */
+    self->ledCount     = ledCount;
+    self->wordCount    = wordCount;
+    self->registerBits = registerBits;
+    self->lastWritten  = self->ledsImage + wordCount;
+    setImage( self, ALL_LEDS_OFF, CALLER() ); /* store the LEDs' state */
+
+    /* set the LEDs' state, nothing is known about the registers yet so all of them are written */
+    for ( reg = 0; reg < registerCountOf( self ); reg++ )
+    {
+        writeRegister( self, reg );
+    }
+
+    return self;
 }
 
-void LedDriver_TurnOn( uint16_t ledNumber )
+void LedDriver_Destroy( LedDriver self )
 {
-    /* only turn on LEDs within the 1-16 range */
-    if ( IsLedInOfBounds( ledNumber ) )
+    /* Deallocate the LED driver (the LEDs are left as they are), only for drivers made by LedDriver_Create()
+       or LedDriver_CreateBank(), the storage given to LedDriver_Init() belongs to the caller */
+    free( self );
+}
+
+void LedDriver_TurnOn( LedDriver self, uint16_t ledNumber )
+{
+    /* only turn on LEDs within the 1-ledCount range */
+    if ( IsLedInOfBounds( self, ledNumber ) )
     {
         /* update the LEDs' state */
-        setLedImageBit( ledNumber );
+        setLedImageBit( self, ledNumber, CALLER() );
 
         /* turn on the specified LED number */
-        updateHardware();
+        updateHardwareLed( self, ledNumber );
     }
     /* if an attempt is made to turn on an out-of-bounds LED */
     else
     {
+        /* the changes that led to the error are the first thing to look at */
+        if ( self->trace != NULL )
+        {
+            LedTrace_Dump( self->trace );
+        }
+
         /* produce a runtime error:
            - the first parameter is the error message
            - the second parameter is the error paramater */
@@ -82,53 +497,191 @@ void LedDriver_TurnOn( uint16_t ledNumber )
     }
 }
 
-void LedDriver_TurnOff( uint16_t ledNumber )
+void LedDriver_TurnOff( LedDriver self, uint16_t ledNumber )
 {
-    /* only turn off LEDs within the 1-16 range */
-    if ( IsLedInOfBounds( ledNumber ) )
+    /* only turn off LEDs within the 1-ledCount range */
+    if ( IsLedInOfBounds( self, ledNumber ) )
     {
         /* update the LEDs' state */
-        clearLedImageBit( ledNumber );
+        clearLedImageBit( self, ledNumber, CALLER() );
 
         /* turn off the specified LED number, */
-        updateHardware();
+        updateHardwareLed( self, ledNumber );
     }
 }
 
-void LedDriver_TurnAllOn( void )
+void LedDriver_TurnAllOn( LedDriver self )
 {
     /* store the LEDs' state */
-    ledsImage = ALL_LEDS_ON;
+    setImage( self, ALL_LEDS_ON, CALLER() );
 
     /* turn on all the LEDs */
-    updateHardware();
+    updateHardware( self );
 }
 
-void LedDriver_TurnAllOff( void )
+void LedDriver_TurnAllOff( LedDriver self )
 {
     /* store the LEDs' state */
-    ledsImage = ALL_LEDS_OFF;
+    setImage( self, ALL_LEDS_OFF, CALLER() );
 
     /* turn on all the LEDs */
-    updateHardware();
+    updateHardware( self );
 }
 
-BOOL LedDriver_IsOn( uint16_t ledNumber )
+BOOL LedDriver_IsOn( LedDriver self, uint16_t ledNumber )
 {
     /* ledNumber's state */
     BOOL ledOn = FALSE;
 
-    /* only evaluate for LEDs within the 1-16 range */
-    if ( IsLedInOfBounds( ledNumber ) )
+    /* only evaluate for LEDs within the 1-ledCount range */
+    if ( IsLedInOfBounds( self, ledNumber ) )
     {
         /* get LedNumber's state */
-        ledOn = ledsImage & ( convertLedNumberToBit( ledNumber ) );
+        ledOn = ( loadImageWord( self, wordIndexOf( ledNumber ) ) & convertLedNumberToBit( ledNumber ) ) != 0;
     }
 
     return ledOn;
 }
 
-BOOL LedDriver_IsOff( uint16_t ledNumber )
+BOOL LedDriver_IsOff( LedDriver self, uint16_t ledNumber )
+{
+    return !LedDriver_IsOn( self, ledNumber );
+}
+
+BOOL LedDriver_AreAllOn( LedDriver self )
+{
+    int i; /* image word index */
+
+    /* every word but the last one must have all of its bits set */
+    for ( i = 0; i < self->wordCount - 1; i++ )
+    {
+        if ( loadImageWord( self, i ) != ( LedWord ) ALL_LEDS_ON )
+        {
+            return FALSE;
+        }
+    }
+
+    /* the last word only needs the bits of actual LEDs set */
+    return loadImageWord( self, i ) == lastWordMask( self );
+}
+
+BOOL LedDriver_AreAllOff( LedDriver self )
+{
+    int i;              /* image word index */
+    LedWord anyOn = 0;  /* accumulated LEDs' state */
+
+    /* no early exit needed, OR-ing the words together is cheaper than branching on every one */
+    for ( i = 0; i < self->wordCount; i++ )
+    {
+        anyOn |= loadImageWord( self, i );
+    }
+
+    return anyOn == 0;
+}
+
+void LedDriver_SetMask( LedDriver self, const LedWord *onMask )
+{
+    int i; /* image word index */
+
+    /* turn on every LED whose bit is set in the mask, one word at a time */
+    for ( i = 0; i < self->wordCount; i++ )
+    {
+        orImageWord( self, i, onMask[ i ] & wordMask( self, i ), CALLER() );
+    }
+
+    /* a single hardware update, no matter how many LEDs changed */
+    updateHardware( self );
+}
+
+void LedDriver_ClearMask( LedDriver self, const LedWord *offMask )
+{
+    int i; /* image word index */
+
+    /* turn off every LED whose bit is set in the mask, one word at a time */
+    for ( i = 0; i < self->wordCount; i++ )
+    {
+        andImageWord( self, i, ~offMask[ i ], CALLER() );
+    }
+
+    /* a single hardware update, no matter how many LEDs changed */
+    updateHardware( self );
+}
+
+void LedDriver_Apply( LedDriver self, const LedWord *onMask, const LedWord *offMask )
+{
+    int i; /* image word index */
+
+    /* turn off the LEDs in offMask, then turn on the LEDs in onMask
+       (a LED present in both masks ends up on) */
+    for ( i = 0; i < self->wordCount; i++ )
+    {
+        applyImageWord( self, i, onMask[ i ] & wordMask( self, i ), offMask[ i ], CALLER() );
+    }
+
+    /* a single hardware update, no matter how many LEDs changed */
+    updateHardware( self );
+}
+
+void LedDriver_BeginUpdate( LedDriver self )
+{
+    /* from now on the operations only update the image, the hardware is updated by LedDriver_Flush().
+       Frames can be nested, only the outermost LedDriver_Flush() updates the hardware */
+    self->updateDepth++;
+}
+
+void LedDriver_Flush( LedDriver self )
+{
+    /* a flush without a matching LedDriver_BeginUpdate() has nothing to end */
+    if ( self->updateDepth > 0 )
+    {
+        self->updateDepth--;
+    }
+
+    /* update the hardware once, and only if something changed during the frame */
+    if ( ( self->updateDepth == 0 ) && self->dirty )
+    {
+        self->dirty = FALSE;
+        updateRegisters( self );
+    }
+}
+
+uint32_t LedDriver_GetRegisterWriteCount( LedDriver self )
+{
+    return __atomic_load_n( &self->registerWrites, __ATOMIC_RELAXED );
+}
+
+void LedDriver_SetConcurrent( LedDriver self, BOOL concurrent )
+{
+    int reg; /* register index */
+
+    /* must be called while the driver is not shared with other threads */
+    self->concurrent = concurrent;
+
+    /* the values last written are not tracked in concurrent mode, so write every register again */
+    if ( !concurrent )
+    {
+        for ( reg = 0; reg < registerCountOf( self ); reg++ )
+        {
+            writeRegister( self, reg );
+        }
+    }
+}
+
+uint16_t LedDriver_GetLedCount( LedDriver self )
+{
+    return self->ledCount;
+}
+
+void LedDriver_SetTrace( LedDriver self, LedTrace trace )
+{
+    /* from now on every change of the image is recorded into 'trace' (NULL stops the recording) */
+    self->trace = trace;
+}
+
+void LedDriver_SetUpdateHook( LedDriver self, LedDriverUpdateHook hook, void *context )
 {
-    return !LedDriver_IsOn( ledNumber );
+    /* NULL by default (no instrumentation, a single test per hardware update).
+       Benchmarks and tests point it to a function that counts the hardware updates of this driver */
+    self->hook        = hook;
+    self->hookContext = context;
 }
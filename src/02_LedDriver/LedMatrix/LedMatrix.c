@@ -0,0 +1,232 @@
+/**
+ * @file    LedMatrix.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Matrix module source file that implements the functions for the Led Matrix module.
+ *
+ *          The matrix keeps two images of every row:
+ *          - the front image, what the row's LedDriver is showing
+ *          - the back image, what is being drawn
+ *          and one dirty bit per row, set whenever a pixel of the row's back image changes.
+ *
+ *          LedMatrix_Flip() walks the dirty bits only (a whole word of rows at a time), so a frame where
+ *          nothing changed costs a handful of word reads no matter how large the matrix is, and a dirty row
+ *          is only pushed to its driver (one LedDriver_Apply()) if its back image really differs from its front image.
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LedMatrix.h"
+#include "RuntimeError.h"
+#include <stdlib.h>
+
+/* structure data type to hold the framebuffer of a LED matrix.
+   The row drivers, the images, the dirty bits and a mask of all the LEDs of a row are allocated right after
+   the structure (same block of memory) */
+typedef struct LedMatrixStruct
+{
+    int rowCount;         /* number of rows */
+    uint16_t columnCount; /* number of LEDs in every row */
+    int wordCount;        /* number of LedWord in the image of a row */
+    LedDriver *rows;      /* driver of every row */
+    LedWord *front;       /* image shown by every row, 'wordCount' words per row */
+    LedWord *back;        /* image drawn for every row, 'wordCount' words per row */
+    LedWord *allLeds;     /* every LED of a row (clears the row's image before the new one is applied) */
+    LedWord dirty[];      /* one bit per row whose back image changed since the last flip (row 1 is bit 0 of dirty[ 0 ]) */
+} LedMatrixStruct;
+
+static BOOL IsPixelInBounds( LedMatrix self, int row, uint16_t column )
+{
+    return ( row >= 1 ) && ( row <= self->rowCount ) && ( column >= 1 ) && ( column <= self->columnCount );
+}
+
+static LedWord *backWordOf( LedMatrix self, int row, uint16_t column )
+{
+    return &self->back[ ( row - 1 ) * self->wordCount + ( column - 1 ) / LED_WORD_BITS ];
+}
+
+static LedWord columnBitOf( uint16_t column )
+{
+    return ( LedWord ) 1 << ( ( column - 1 ) % LED_WORD_BITS );
+}
+
+static void markDirty( LedMatrix self, int row )
+{
+    self->dirty[ ( row - 1 ) / LED_WORD_BITS ] |= ( LedWord ) 1 << ( ( row - 1 ) % LED_WORD_BITS );
+}
+
+static BOOL pushRow( LedMatrix self, int rowIndex )
+{
+    int i; /* image word index */
+    LedWord *front = &self->front[ rowIndex * self->wordCount ];
+    LedWord *back  = &self->back[ rowIndex * self->wordCount ];
+    LedWord changed = 0;
+
+    /* pixels changed and changed back between two flips leave nothing to push */
+    for ( i = 0; i < self->wordCount; i++ )
+    {
+        changed |= front[ i ] ^ back[ i ];
+        front[ i ] = back[ i ];
+    }
+
+    if ( changed == 0 )
+    {
+        return FALSE;
+    }
+
+    /* the whole row in a single hardware update */
+    LedDriver_Apply( self->rows[ rowIndex ], front, self->allLeds );
+
+    return TRUE;
+}
+
+LedMatrix LedMatrix_Create( LedDriver *rows, int rowCount )
+{
+    LedMatrix self;
+    int i;
+    uint16_t columnCount;
+    int wordCount;
+    int dirtyCount = ( rowCount + LED_WORD_BITS - 1 ) / LED_WORD_BITS;
+    LedWord *images;
+
+    /* a matrix needs at least one row */
+    if ( rowCount < 1 )
+    {
+        RUNTIME_ERROR( "LED Matrix: empty matrix", rowCount );
+        return NULL;
+    }
+
+    columnCount = LedDriver_GetLedCount( rows[ 0 ] );
+    wordCount   = ( columnCount + LED_WORD_BITS - 1 ) / LED_WORD_BITS;
+
+    /* every row must have the same number of LEDs */
+    for ( i = 1; i < rowCount; i++ )
+    {
+        if ( LedDriver_GetLedCount( rows[ i ] ) != columnCount )
+        {
+            RUNTIME_ERROR( "LED Matrix: rows of different widths", i + 1 );
+            return NULL;
+        }
+    }
+
+    /* Allocate (dynamically) a block of memory to store the matrix, its dirty bits, its row drivers,
+       both images of every row and the mask of all the LEDs of a row, all of them initialized to zero */
+    self = calloc( 1, sizeof( LedMatrixStruct ) + dirtyCount * sizeof( LedWord )
+                      + ( 2 * rowCount + 1 ) * wordCount * sizeof( LedWord ) + rowCount * sizeof( LedDriver ) );
+
+    self->rowCount    = rowCount;
+    self->columnCount = columnCount;
+    self->wordCount   = wordCount;
+
+    /* the images follow the dirty bits, the row drivers go last */
+    images        = self->dirty + dirtyCount;
+    self->front   = images;
+    self->back    = images + rowCount * wordCount;
+    self->allLeds = images + 2 * rowCount * wordCount;
+    self->rows    = ( LedDriver * ) ( self->allLeds + wordCount );
+
+    for ( i = 0; i < wordCount; i++ )
+    {
+        self->allLeds[ i ] = ~( LedWord ) 0;
+    }
+
+    /* the rows are shown blank right away, from then on they are only written when they change */
+    for ( i = 0; i < rowCount; i++ )
+    {
+        self->rows[ i ] = rows[ i ];
+        LedDriver_TurnAllOff( rows[ i ] );
+    }
+
+    /* return the address of the recently allocated matrix */
+    return self;
+}
+
+void LedMatrix_Destroy( LedMatrix self )
+{
+    /* Deallocate the matrix (the row drivers belong to the caller, the LEDs are left as they are) */
+    free( self );
+}
+
+void LedMatrix_SetPixel( LedMatrix self, int row, uint16_t column, BOOL on )
+{
+    LedWord *word;
+    LedWord drawn;
+
+    if ( !IsPixelInBounds( self, row, column ) )
+    {
+        RUNTIME_ERROR( "LED Matrix: out-of-bounds pixel", row );
+        return;
+    }
+
+    word  = backWordOf( self, row, column );
+    drawn = on ? ( *word | columnBitOf( column ) ) : ( *word & ~columnBitOf( column ) );
+
+    /* drawing what is already there does not make the row dirty */
+    if ( drawn != *word )
+    {
+        *word = drawn;
+        markDirty( self, row );
+    }
+}
+
+BOOL LedMatrix_GetPixel( LedMatrix self, int row, uint16_t column )
+{
+    /* out-of-bounds pixels are always off */
+    if ( !IsPixelInBounds( self, row, column ) )
+    {
+        return FALSE;
+    }
+
+    /* the pixel as drawn (it may not be shown yet) */
+    return ( *backWordOf( self, row, column ) & columnBitOf( column ) ) != 0;
+}
+
+void LedMatrix_Clear( LedMatrix self )
+{
+    int row;
+    int i; /* image word index */
+
+    for ( row = 1; row <= self->rowCount; row++ )
+    {
+        LedWord *back = &self->back[ ( row - 1 ) * self->wordCount ];
+        LedWord lit   = 0;
+
+        for ( i = 0; i < self->wordCount; i++ )
+        {
+            lit |= back[ i ];
+            back[ i ] = 0;
+        }
+
+        /* only the rows that had something drawn change */
+        if ( lit != 0 )
+        {
+            markDirty( self, row );
+        }
+    }
+}
+
+int LedMatrix_Flip( LedMatrix self )
+{
+    int i;          /* dirty word index */
+    int pushed = 0; /* number of rows written to the hardware */
+    int dirtyCount = ( self->rowCount + LED_WORD_BITS - 1 ) / LED_WORD_BITS;
+
+    for ( i = 0; i < dirtyCount; i++ )
+    {
+        LedWord dirty = self->dirty[ i ];
+
+        self->dirty[ i ] = 0;
+
+        /* visit the dirty rows only, lowest row first */
+        while ( dirty != 0 )
+        {
+            int rowIndex = i * LED_WORD_BITS + __builtin_ctzll( dirty );
+
+            pushed += pushRow( self, rowIndex );
+            dirty &= dirty - 1;
+        }
+    }
+
+    /* return the number of rows that were written to the hardware */
+    return pushed;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file    LedPwm.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led PWM module source file that implements the functions for the Led PWM module.
+ *
+ *          The brightness is produced with bit angle modulation: the gamma corrected level of every LED
+ *          (0-255) is split into its 8 bits, and bit k of all the LEDs is stored as an image of the bank
+ *          (bit plane k). A PWM period shows plane 0 for 1 tick, plane 1 for 2 ticks ... plane 7 for 128 ticks,
+ *          so a LED is on for exactly 'level' of the 255 ticks of the period.
+ *
+ *          The planes are kept up to date by LedPwm_SetBrightness() (8 bits changed per call), so LedPwm_Tick():
+ *          - never looks at individual LEDs (no per-LED branching)
+ *          - writes the LED image once per plane (8 times per period) with a single LedDriver_Apply()
+ *          - only counts down the rest of the time
+ *
+ *          The planes are double-buffered: LedPwm_SetBrightness() changes the pending planes and LedPwm_Tick()
+ *          swaps them with the shown ones when a period starts, so a period never mixes the old and the new duty
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LedPwm.h"
+#include "RuntimeError.h"
+#include <stdlib.h>
+#include <string.h> /* memcpy() */
+
+enum { PLANES = 8 }; /* one bit plane per bit of the brightness */
+
+/* gamma correction (2.2), so equal brightness steps look like equal steps to the eye */
+static const uint8_t gammaTable[ 256 ] =
+{
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+/* structure data type to hold the PWM state of one LED bank.
+   The two sets of bit planes, a mask of all the LEDs and the brightness of every LED are allocated right after
+   the structure (same block of memory) */
+typedef struct LedPwmStruct
+{
+    LedDriver driver;       /* driver of the LED bank */
+    uint16_t ledCount;      /* number of LEDs in the bank */
+    uint16_t wordCount;     /* number of LedWord in every plane */
+    uint8_t plane;          /* plane currently shown */
+    uint8_t remaining;      /* ticks left before the next plane is shown */
+    BOOL pending;           /* the pending planes changed since the period started */
+    LedWord *shownPlanes;   /* planes of the current period (only read by LedPwm_Tick()) */
+    LedWord *pendingPlanes; /* planes of the next period (changed by LedPwm_SetBrightness()) */
+    LedWord *allLeds;       /* every LED of the bank (clears the image before a plane is applied) */
+    uint8_t *brightness;    /* brightness set for every LED, as given by the user */
+    LedWord planes[];       /* 2 x PLANES images of the bank, plane k holds bit k of every LED's level */
+} LedPwmStruct;
+
+LedPwm LedPwm_Create( LedDriver driver )
+{
+    LedPwm self;
+    int i; /* word index */
+    uint16_t ledCount = LedDriver_GetLedCount( driver );
+    int wordCount = ( ledCount + LED_WORD_BITS - 1 ) / LED_WORD_BITS;
+
+    /* Allocate (dynamically) a block of memory to store the PWM state, its planes, the mask of all the LEDs
+       and the brightness of every LED, all of them initialized to zero (every LED off) */
+    self = calloc( 1, sizeof( LedPwmStruct ) + ( 2 * PLANES + 1 ) * wordCount * sizeof( LedWord ) + ledCount );
+
+    self->driver        = driver;
+    self->ledCount      = ledCount;
+    self->wordCount     = wordCount;
+    self->shownPlanes   = self->planes;
+    self->pendingPlanes = self->planes + PLANES * wordCount;
+    self->allLeds       = self->planes + 2 * PLANES * wordCount;
+    self->brightness = ( uint8_t * ) ( self->allLeds + wordCount );
+
+    /* the driver keeps the bits beyond the last LED off, so the whole last word can be used */
+    for ( i = 0; i < wordCount; i++ )
+    {
+        self->allLeds[ i ] = ~( LedWord ) 0;
+    }
+
+    /* the first tick starts the period with plane 0 */
+    self->plane     = PLANES - 1;
+    self->remaining = 0;
+
+    /* return the address of the recently allocated PWM state */
+    return self;
+}
+
+void LedPwm_Destroy( LedPwm self )
+{
+    /* Deallocate the PWM state (the LEDs are left as they are) */
+    free( self );
+}
+
+void LedPwm_SetBrightness( LedPwm self, uint16_t ledNumber, uint8_t brightness )
+{
+    int k;          /* plane index */
+    int word;       /* word of every plane that holds the LED */
+    LedWord bit;    /* bit of the word that holds the LED */
+    uint8_t level;  /* gamma corrected brightness */
+
+    /* only LEDs within the 1-ledCount range have a brightness */
+    if ( ( ledNumber < 1 ) || ( ledNumber > self->ledCount ) )
+    {
+        RUNTIME_ERROR( "LED PWM: out-of-bounds LED", ledNumber );
+        return;
+    }
+
+    word  = ( ledNumber - 1 ) / LED_WORD_BITS;
+    bit   = ( LedWord ) 1 << ( ( ledNumber - 1 ) % LED_WORD_BITS );
+    level = gammaTable[ brightness ];
+
+    self->brightness[ ledNumber - 1 ] = brightness;
+
+    /* store every bit of the level into its pending plane (takes effect when the next period starts) */
+    for ( k = 0; k < PLANES; k++ )
+    {
+        LedWord *planeWord = &self->pendingPlanes[ k * self->wordCount + word ];
+
+        *planeWord = ( level & ( 1 << k ) ) ? ( *planeWord | bit ) : ( *planeWord & ~bit );
+    }
+
+    self->pending = TRUE;
+}
+
+static void swapPlanes( LedPwm self )
+{
+    LedWord *planes = self->shownPlanes;
+
+    /* the pending planes are shown from now on ... */
+    self->shownPlanes   = self->pendingPlanes;
+    self->pendingPlanes = planes;
+    self->pending       = FALSE;
+
+    /* ... and the next changes start from them */
+    memcpy( self->pendingPlanes, self->shownPlanes, PLANES * self->wordCount * sizeof( LedWord ) );
+}
+
+uint8_t LedPwm_GetBrightness( LedPwm self, uint16_t ledNumber )
+{
+    /* out-of-bounds LEDs are always off */
+    if ( ( ledNumber < 1 ) || ( ledNumber > self->ledCount ) )
+    {
+        return 0;
+    }
+
+    return self->brightness[ ledNumber - 1 ];
+}
+
+void LedPwm_Tick( LedPwm self )
+{
+    /* when the current plane has been shown long enough, show the next one:
+       every LED is turned off, then the LEDs whose bit is set in the plane are turned on (one image write) */
+    if ( self->remaining == 0 )
+    {
+        self->plane     = ( self->plane + 1 ) % PLANES;
+        self->remaining = 1 << self->plane;
+
+        /* the brightness only changes between periods */
+        if ( ( self->plane == 0 ) && self->pending )
+        {
+            swapPlanes( self );
+        }
+
+        LedDriver_Apply( self->driver, &self->shownPlanes[ self->plane * self->wordCount ], self->allLeds );
+    }
+
+    self->remaining--;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file    LedRegisterPage.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Register Page source file that implements the functions for the Led Register Page module.
+ *
+ *          On the target the LED registers live at a fixed (memory-mapped) address.
+ *          On a development box there are no LED registers, so this module provides the memory the
+ *          LED driver writes to, either plain in-process memory or a shared mapping of a file.
+ *          With the file mapping the register writes are real stores to a shared page, so their cost
+ *          and ordering can be measured, and a second process can watch the "LEDs" change.
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LedRegisterPage.h"
+#include "RuntimeError.h"
+#include <stdlib.h>
+#include <errno.h>    /* errno */
+#include <fcntl.h>    /* open() */
+#include <unistd.h>   /* ftruncate() / close() */
+#include <sys/mman.h> /* mmap() / munmap() / msync() */
+#include <sys/stat.h> /* fstat() */
+
+/* structure data type to hold a register page */
+typedef struct LedRegisterPageStruct
+{
+    volatile void *address; /* first byte of the page */
+    size_t size;            /* size of the page in bytes */
+    int fd;                 /* file descriptor of the mapped file (-1 for in-process memory) */
+} LedRegisterPageStruct;
+
+LedRegisterPage LedRegisterPage_CreateInMemory( size_t size )
+{
+    /* Allocate (dynamically) the page and the memory standing in for the registers */
+    LedRegisterPage self = calloc( 1, sizeof( LedRegisterPageStruct ) );
+
+    self->address = calloc( 1, size );
+    self->size    = size;
+    self->fd      = -1;
+
+    return self;
+}
+
+LedRegisterPage LedRegisterPage_MapFile( const char *path, size_t size )
+{
+    LedRegisterPage self;
+    void *address;
+    struct stat status;
+    int error;
+
+    /* open (or create) the file standing in for the registers */
+    int fd = open( path, O_RDWR | O_CREAT, 0644 );
+
+    if ( fd < 0 )
+    {
+        RUNTIME_ERROR( "LED Register Page: cannot open file", errno );
+        return NULL;
+    }
+
+    /* the file must be at least as big as the page, otherwise accessing the mapping faults.
+       A bigger file is left as it is, whatever lies beyond the page is not ours to drop */
+    if ( ( fstat( fd, &status ) != 0 )
+      || ( ( ( size_t ) status.st_size < size ) && ( ftruncate( fd, size ) != 0 ) ) )
+    {
+        error = errno; /* close() may change it */
+        close( fd );
+        RUNTIME_ERROR( "LED Register Page: cannot size file", error );
+        return NULL;
+    }
+
+    /* a shared mapping, so the writes go to the file (and to every other mapping of it) */
+    address = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+
+    if ( address == MAP_FAILED )
+    {
+        error = errno;
+        close( fd );
+        RUNTIME_ERROR( "LED Register Page: cannot map file", error );
+        return NULL;
+    }
+
+    self = calloc( 1, sizeof( LedRegisterPageStruct ) );
+
+    self->address = address;
+    self->size    = size;
+    self->fd      = fd;
+
+    return self;
+}
+
+void LedRegisterPage_Destroy( LedRegisterPage self )
+{
+    /* release the memory standing in for the registers */
+    if ( self->fd < 0 )
+    {
+        free( ( void * ) self->address );
+    }
+    else
+    {
+        munmap( ( void * ) self->address, self->size );
+        close( self->fd );
+    }
+
+    /* Deallocate the register page */
+    free( self );
+}
+
+volatile void *LedRegisterPage_GetAddress( LedRegisterPage self )
+{
+    return self->address;
+}
+
+void LedRegisterPage_Sync( LedRegisterPage self )
+{
+    /* Other processes sharing the mapping (or reading the file) already see the writes,
+       this only matters when the file itself has to reach the disk, e.g. before a power cut */
+    if ( self->fd >= 0 )
+    {
+        msync( ( void * ) self->address, self->size, MS_SYNC );
+    }
+}
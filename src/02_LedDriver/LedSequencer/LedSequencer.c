@@ -0,0 +1,169 @@
+/**
+ * @file    LedSequencer.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Sequencer module source file that implements the functions for the Led Sequencer module.
+ *
+ *          The frames are precomputed images of the LED bank, stored in a table when they are defined.
+ *          The queue of frames to play is a CircularBuffer: every entry packs the frame id (upper 16 bits)
+ *          and the number of ticks it is shown (lower 16 bits) into a single int, so queueing a frame or
+ *          starting it never copies an image around.
+ *
+ *          When the queue runs out, the last frame stays on the LEDs.
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LedSequencer.h"
+#include "CircularBuffer.h"
+#include "RuntimeError.h"
+#include <stdlib.h>
+
+/* structure data type to hold the state of the sequencer of one LED bank.
+   The frame table and a mask of all the LEDs are allocated right after the structure (same block of memory) */
+typedef struct LedSequencerStruct
+{
+    LedDriver driver;      /* driver of the LED bank */
+    CircularBuffer queue;  /* frames waiting to be played (frame id and ticks packed together) */
+    int frameCount;        /* number of frames in the table */
+    int wordCount;         /* number of LedWord in every frame */
+    uint16_t remaining;    /* ticks left before the next frame is started */
+    LedWord *allLeds;      /* every LED of the bank (clears the image before a frame is applied) */
+    LedWord frames[];      /* frame table, 'frameCount' images of the bank */
+} LedSequencerStruct;
+
+static int packEntry( int frameId, uint16_t ticks )
+{
+    return ( frameId << 16 ) | ticks;
+}
+
+static int frameIdOf( int entry )
+{
+    return entry >> 16;
+}
+
+static uint16_t ticksOf( int entry )
+{
+    return ( uint16_t ) ( entry & 0xffff );
+}
+
+static BOOL IsFrameInBounds( LedSequencer self, int frameId )
+{
+    return ( frameId >= 0 ) && ( frameId < self->frameCount );
+}
+
+LedSequencer LedSequencer_Create( LedDriver driver, int frameCount, int queueCapacity )
+{
+    LedSequencer self;
+    int i; /* word index */
+    int wordCount = ( LedDriver_GetLedCount( driver ) + LED_WORD_BITS - 1 ) / LED_WORD_BITS;
+
+    /* the frame id has to fit in the upper half of a queue entry */
+    if ( ( frameCount < 1 ) || ( frameCount > LEDSEQUENCER_MAX_FRAMES ) )
+    {
+        RUNTIME_ERROR( "LED Sequencer: unsupported frame count", frameCount );
+        return NULL;
+    }
+
+    /* a queue that cannot hold a single frame would never play anything */
+    if ( queueCapacity < 1 )
+    {
+        RUNTIME_ERROR( "LED Sequencer: empty queue", queueCapacity );
+        return NULL;
+    }
+
+    /* Allocate (dynamically) a block of memory to store the sequencer, its frame table (all frames off)
+       and the mask of all the LEDs */
+    self = calloc( 1, sizeof( LedSequencerStruct ) + ( frameCount + 1 ) * wordCount * sizeof( LedWord ) );
+
+    if ( self == NULL )
+    {
+        RUNTIME_ERROR( "LED Sequencer: out of memory", frameCount );
+        return NULL;
+    }
+
+    self->queue = CircularBuffer_Create( queueCapacity );
+
+    self->driver     = driver;
+    self->frameCount = frameCount;
+    self->wordCount  = wordCount;
+    self->allLeds    = self->frames + frameCount * wordCount;
+
+    /* the driver keeps the bits beyond the last LED off, so the whole last word can be used */
+    for ( i = 0; i < wordCount; i++ )
+    {
+        self->allLeds[ i ] = ~( LedWord ) 0;
+    }
+
+    /* return the address of the recently allocated sequencer */
+    return self;
+}
+
+void LedSequencer_Destroy( LedSequencer self )
+{
+    /* Deallocate the queue and the sequencer (the LEDs are left as they are) */
+    CircularBuffer_Destroy( self->queue );
+    free( self );
+}
+
+void LedSequencer_DefineFrame( LedSequencer self, int frameId, const LedWord *image )
+{
+    int i; /* word index */
+
+    if ( !IsFrameInBounds( self, frameId ) )
+    {
+        RUNTIME_ERROR( "LED Sequencer: unknown frame", frameId );
+        return;
+    }
+
+    /* copy the image into the frame table, the frame is now ready to be queued any number of times */
+    for ( i = 0; i < self->wordCount; i++ )
+    {
+        self->frames[ frameId * self->wordCount + i ] = image[ i ];
+    }
+}
+
+BOOL LedSequencer_Queue( LedSequencer self, int frameId, uint16_t ticks )
+{
+    if ( !IsFrameInBounds( self, frameId ) )
+    {
+        RUNTIME_ERROR( "LED Sequencer: unknown frame", frameId );
+        return FALSE;
+    }
+
+    /* a frame has to be shown for at least one tick */
+    if ( ticks == 0 )
+    {
+        RUNTIME_ERROR( "LED Sequencer: empty frame duration", frameId );
+        return FALSE;
+    }
+
+    /* FALSE when the queue is full, the producer can try again later */
+    return CircularBuffer_Put( self->queue, packEntry( frameId, ticks ) );
+}
+
+void LedSequencer_Tick( LedSequencer self )
+{
+    int entry; /* next frame and its duration */
+
+    /* when the current frame has been shown long enough, start the next one (if any) */
+    if ( ( self->remaining == 0 ) && !CircularBuffer_IsEmpty( self->queue ) )
+    {
+        entry = CircularBuffer_Get( self->queue );
+        self->remaining = ticksOf( entry );
+
+        /* every LED is turned off and the LEDs of the frame are turned on (one image write) */
+        LedDriver_Apply( self->driver, &self->frames[ frameIdOf( entry ) * self->wordCount ], self->allLeds );
+    }
+
+    if ( self->remaining > 0 )
+    {
+        self->remaining--;
+    }
+}
+
+BOOL LedSequencer_IsIdle( LedSequencer self )
+{
+    /* nothing is being played and nothing is waiting to be played */
+    return ( self->remaining == 0 ) && CircularBuffer_IsEmpty( self->queue );
+}
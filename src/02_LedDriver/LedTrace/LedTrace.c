@@ -0,0 +1,176 @@
+/**
+ * @file    LedTrace.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Led Trace module source file that implements the functions for the Led Trace module.
+ *
+ *          Every record claims the next slot of the ring with an atomic increment of 'recorded' and fills it in,
+ *          so recording costs a timestamp, one atomic add and a handful of stores (no lock, no allocation).
+ *          The oldest entries are overwritten once the ring is full.
+ *
+ *          The default timestamp is the cycle counter of the CPU where there is one (rdtsc on x86,
+ *          cntvct_el0 on AArch64) and a coarse monotonic clock elsewhere: clock_gettime( CLOCK_MONOTONIC )
+ *          costs several times a whole LED update, the counters a few nanoseconds.
+ *
+ *          Every slot carries the sequence number of the record it holds (record number + 1), cleared before
+ *          the slot is filled in and stored last with release semantics. A reader checks it before and after
+ *          copying the entry (as a seqlock reader does), so an entry that is being written or has been overwritten
+ *          by a newer record while it was read comes back with sequence 0 instead of torn. The check cannot tell
+ *          two writers apart on the same slot, which takes a writer stalled for a whole lap of the ring.
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LedTrace.h"
+#include "RuntimeError.h"
+#include "Utils.h" /* FormatOutput() */
+#include <stdlib.h>
+#include <time.h>  /* clock_gettime() */
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+    #include <x86intrin.h> /* __rdtsc() */
+#endif
+
+/* structure data type to hold a trace ring, the entries are allocated right after the structure */
+typedef struct LedTraceStruct
+{
+    uint32_t mask;           /* capacity - 1, turns the number of records into a slot index */
+    uint32_t recorded;       /* number of records since the trace was created */
+    LedTraceEntry entries[]; /* ring of entries */
+} LedTraceStruct;
+
+static uint64_t LedTrace_GetTimestampImpl( void )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc();
+#elif defined( __aarch64__ )
+    uint64_t ticks;
+
+    __asm__ volatile( "mrs %0, cntvct_el0" : "=r"( ticks ) );
+
+    return ticks;
+#else
+    struct timespec now;
+
+    #ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime( CLOCK_MONOTONIC_COARSE, &now );
+    #else
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    #endif
+
+    return ( uint64_t ) now.tv_sec * 1000000000u + ( uint64_t ) now.tv_nsec;
+#endif
+}
+
+/* The function pointer is initialized to point to the "production" time source */
+uint64_t ( *LedTrace_GetTimestamp )( void ) = LedTrace_GetTimestampImpl;
+
+LedTrace LedTrace_Create( int capacity )
+{
+    LedTrace self;
+
+    /* the slot index is computed with a mask, so only powers of two are supported */
+    if ( ( capacity < 1 ) || ( ( capacity & ( capacity - 1 ) ) != 0 ) )
+    {
+        RUNTIME_ERROR( "LED Trace: capacity is not a power of two", capacity );
+        return NULL;
+    }
+
+    /* Allocate (dynamically) a block of memory to store the trace and its entries */
+    self = calloc( 1, sizeof( LedTraceStruct ) + capacity * sizeof( LedTraceEntry ) );
+
+    self->mask = capacity - 1;
+
+    /* return the address of the recently allocated trace */
+    return self;
+}
+
+void LedTrace_Destroy( LedTrace self )
+{
+    /* Deallocate the trace and its entries */
+    free( self );
+}
+
+void LedTrace_Record( LedTrace self, uint16_t word, LedWord oldImage, LedWord newImage, const void *caller )
+{
+    /* claim a slot, every thread gets its own */
+    uint32_t record = __atomic_fetch_add( &self->recorded, 1, __ATOMIC_RELAXED );
+    LedTraceEntry *entry = &self->entries[ record & self->mask ];
+
+    /* mark the slot as being written before touching the fields */
+    __atomic_store_n( &entry->sequence, 0, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    entry->timestamp = LedTrace_GetTimestamp();
+    entry->caller    = caller;
+    entry->word      = word;
+    entry->oldImage  = oldImage;
+    entry->newImage  = newImage;
+
+    /* publish the entry: a reader that sees this sequence number sees the fields above */
+    __atomic_store_n( &entry->sequence, record + 1, __ATOMIC_RELEASE );
+}
+
+/* number of entries in the ring once 'recorded' records were made */
+static uint32_t countOf( LedTrace self, uint32_t recorded )
+{
+    /* once the ring is full, it always holds 'capacity' entries */
+    return ( recorded > self->mask ) ? self->mask + 1 : recorded;
+}
+
+/* copy of the entry of a record, with sequence 0 if the slot does not hold that record from start to end of the copy */
+static LedTraceEntry readEntry( LedTrace self, uint32_t record )
+{
+    LedTraceEntry *slot = &self->entries[ record & self->mask ];
+    uint32_t before = __atomic_load_n( &slot->sequence, __ATOMIC_ACQUIRE );
+    LedTraceEntry entry = *slot;
+
+    /* the fields must be copied before the sequence number is checked again */
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+
+    if ( ( before != record + 1 ) || ( __atomic_load_n( &slot->sequence, __ATOMIC_RELAXED ) != before ) )
+    {
+        entry.sequence = 0;
+    }
+
+    return entry;
+}
+
+int LedTrace_GetCount( LedTrace self )
+{
+    return ( int ) countOf( self, __atomic_load_n( &self->recorded, __ATOMIC_ACQUIRE ) );
+}
+
+LedTraceEntry LedTrace_GetEntry( LedTrace self, int index )
+{
+    uint32_t recorded = __atomic_load_n( &self->recorded, __ATOMIC_ACQUIRE );
+
+    /* entry 0 is the oldest entry still in the ring */
+    return readEntry( self, recorded - countOf( self, recorded ) + index );
+}
+
+void LedTrace_Dump( LedTrace self )
+{
+    /* a single snapshot of 'recorded', so the count and the entries dumped agree */
+    uint32_t recorded = __atomic_load_n( &self->recorded, __ATOMIC_ACQUIRE );
+    uint32_t count = countOf( self, recorded );
+    uint32_t i;
+
+    FormatOutput( "LED trace (%u entries):\n", count );
+
+    /* from the oldest to the most recent change */
+    for ( i = 0; i < count; i++ )
+    {
+        LedTraceEntry entry = readEntry( self, recorded - count + i );
+
+        if ( entry.sequence == 0 )
+        {
+            FormatOutput( "(entry overwritten while dumping)\n" );
+            continue;
+        }
+
+        FormatOutput( "%llu: word %u 0x%llx -> 0x%llx (caller %p)\n",
+                      ( unsigned long long ) entry.timestamp, entry.word,
+                      ( unsigned long long ) entry.oldImage, ( unsigned long long ) entry.newImage, entry.caller );
+    }
+}
@@ -0,0 +1,297 @@
+/**
+ * @file    LightSchedulerImport.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Light Scheduler Import module source file that loads a whole schedule into a light scheduler.
+ *
+ *          A file is streamed a row at a time (a CSV line or a binary record), so its size is not limited
+ *          by memory. Every row is validated and scheduled on its own: a row that cannot be read or scheduled
+ *          is reported through the error callback and the import carries on with the next one.
+ *
+ *          The rows are scheduled inside a LightScheduler batch, so the light scheduler refills its hash table,
+ *          compiles its masks and arms its alarm once for the whole file instead of once per event.
+ *
+ *          Binary records are 32-bit little-endian words:
+ *          - bits 0 to 10:  minute of the day
+ *          - bits 11 to 15: light id
+ *          - bits 16 to 22: days (a mask of Days)
+ *          - bit 23:        1 to turn the light on, 0 to turn it off
+ *          - bits 24 to 31: reserved, always 0
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "LightSchedulerImport.h"
+#include "common.h"
+#include <stdio.h>  /* fopen() / fgets() / fread() / fclose() */
+#include <stdlib.h> /* strtol() */
+#include <string.h> /* strncmp() / strlen() / strchr() / memcmp() */
+
+enum
+{
+    MAX_CSV_LINE   = 128,  /* longest CSV line, newline not included (any longer line is a bad row) */
+    RECORDS_CHUNK  = 1024  /* number of binary records read at a time */
+};
+
+/* name of every set of days a CSV row can use */
+static const struct
+{
+    const char *name;
+    Days days;
+} dayNames[] =
+{
+    { "SUNDAY",    DAYS_SUNDAY    }, { "MONDAY",   DAYS_MONDAY   }, { "TUESDAY", DAYS_TUESDAY },
+    { "WEDNESDAY", DAYS_WEDNESDAY }, { "THURSDAY", DAYS_THURSDAY }, { "FRIDAY",  DAYS_FRIDAY  },
+    { "SATURDAY",  DAYS_SATURDAY  },
+    { "EVERYDAY",  DAYS_EVERYDAY  }, { "WEEKDAY",  DAYS_WEEKDAY  }, { "WEEKEND", DAYS_WEEKEND }
+};
+
+static void reportError( ImportErrorCallback onError, void *context, long row, int status )
+{
+    if ( onError != NULL )
+    {
+        onError( context, row, status );
+    }
+}
+
+static int scheduleRow( LightScheduler scheduler, int turnOn, int id, Days days, int minuteOfDay )
+{
+    return turnOn ? LightScheduler_ScheduleTurnOnDays( scheduler, id, days, minuteOfDay )
+                  : LightScheduler_ScheduleTurnOffDays( scheduler, id, days, minuteOfDay );
+}
+
+static const char *skipBlanks( const char *text )
+{
+    while ( ( *text == ' ' ) || ( *text == '\t' ) )
+    {
+        text++;
+    }
+
+    return text;
+}
+
+static int endOfField( const char *text )
+{
+    /* a field ends at the separator, or at the end of the line for the last one */
+    text = skipBlanks( text );
+
+    return ( *text == ',' ) || ( *text == '\0' ) || ( *text == '\n' ) || ( *text == '\r' );
+}
+
+static int isBlankOrComment( const char *line )
+{
+    char first = *skipBlanks( line );
+
+    return ( first == '#' ) || ( first == '\0' ) || ( first == '\n' ) || ( first == '\r' );
+}
+
+static const char *parseNumber( const char *text, int *value )
+{
+    char *end;
+    long number = strtol( text, &end, 10 );
+
+    /* no digits, or something else than blanks before the end of the field */
+    if ( ( end == text ) || !endOfField( end ) || ( number < -32768 ) || ( number > 32767 ) )
+        return NULL;
+
+    *value = ( int ) number;
+
+    return skipBlanks( end );
+}
+
+static const char *parseDays( const char *text, Days *days )
+{
+    size_t i; /* day name index */
+
+    *days = DAYS_NONE;
+
+    for ( ;; )
+    {
+        for ( i = 0; i < sizeof( dayNames ) / sizeof( dayNames[ 0 ] ); i++ )
+        {
+            size_t length = strlen( dayNames[ i ].name );
+
+            if ( strncmp( text, dayNames[ i ].name, length ) == 0 )
+                break;
+        }
+
+        /* unknown day name */
+        if ( i == sizeof( dayNames ) / sizeof( dayNames[ 0 ] ) )
+            return NULL;
+
+        *days = ( Days ) ( *days | dayNames[ i ].days );
+        text = skipBlanks( text + strlen( dayNames[ i ].name ) );
+
+        /* another day name follows */
+        if ( *text != '|' )
+            break;
+
+        text = skipBlanks( text + 1 );
+    }
+
+    return endOfField( text ) ? text : NULL;
+}
+
+static int parseCsvRow( const char *line, int *turnOn, int *id, Days *days, int *minuteOfDay )
+{
+    const char *text = skipBlanks( line );
+
+    /* on or off */
+    if ( strncmp( text, "on", 2 ) == 0 )
+    {
+        *turnOn = TRUE;
+        text += 2;
+    }
+    else if ( strncmp( text, "off", 3 ) == 0 )
+    {
+        *turnOn = FALSE;
+        text += 3;
+    }
+    else
+        return FALSE;
+
+    /* every field is followed by a comma, but the last one */
+    text = skipBlanks( text );
+    if ( *text++ != ',' )
+        return FALSE;
+
+    if ( ( text = parseNumber( skipBlanks( text ), id ) ) == NULL || ( *text++ != ',' ) )
+        return FALSE;
+
+    if ( ( text = parseDays( skipBlanks( text ), days ) ) == NULL || ( *text++ != ',' ) )
+        return FALSE;
+
+    return parseNumber( skipBlanks( text ), minuteOfDay ) != NULL;
+}
+
+long LightSchedulerImport_Csv( LightScheduler scheduler, const char *path, ImportErrorCallback onError, void *context )
+{
+    char line[ MAX_CSV_LINE + 2 ]; /* the longest line, its newline and the terminating null character */
+    long row = 0;      /* number of the current line */
+    long imported = 0; /* number of events scheduled */
+    FILE *file = fopen( path, "r" );
+
+    if ( file == NULL )
+        return LS_IMPORT_FAILED;
+
+    LightScheduler_BeginBatch( scheduler );
+
+    while ( fgets( line, sizeof( line ), file ) != NULL )
+    {
+        int turnOn, id, minuteOfDay;
+        Days days;
+        int status;
+
+        row++;
+
+        /* a line that does not fit is a bad row, the rest of it is dropped (the last line may have no newline) */
+        if ( strchr( line, '\n' ) == NULL )
+        {
+            int c = fgetc( file );
+
+            if ( c != EOF )
+            {
+                while ( ( c != '\n' ) && ( c != EOF ) )
+                {
+                    c = fgetc( file );
+                }
+
+                reportError( onError, context, row, LS_BAD_ROW );
+                continue;
+            }
+        }
+
+        /* empty lines and comments */
+        if ( isBlankOrComment( line ) )
+            continue;
+
+        if ( !parseCsvRow( line, &turnOn, &id, &days, &minuteOfDay ) )
+        {
+            reportError( onError, context, row, LS_BAD_ROW );
+            continue;
+        }
+
+        status = scheduleRow( scheduler, turnOn, id, days, minuteOfDay );
+
+        if ( status == LS_OK )
+            imported++;
+        else
+            reportError( onError, context, row, status );
+    }
+
+    LightScheduler_EndBatch( scheduler );
+    fclose( file );
+
+    return imported;
+}
+
+long LightSchedulerImport_Binary( LightScheduler scheduler, const char *path, ImportErrorCallback onError, void *context )
+{
+    unsigned char magic[ LS_IMPORT_MAGIC_SIZE ];
+    unsigned char records[ RECORDS_CHUNK * LS_IMPORT_RECORD_SIZE ];
+    long row = 0;      /* number of the current record */
+    long imported = 0; /* number of events scheduled */
+    size_t bytes;      /* number of bytes read into records */
+    FILE *file = fopen( path, "rb" );
+
+    if ( file == NULL )
+        return LS_IMPORT_FAILED;
+
+    /* not a binary schedule */
+    if ( ( fread( magic, 1, sizeof( magic ), file ) != sizeof( magic ) )
+      || ( memcmp( magic, LS_IMPORT_MAGIC, sizeof( magic ) ) != 0 ) )
+    {
+        fclose( file );
+        return LS_IMPORT_FAILED;
+    }
+
+    LightScheduler_BeginBatch( scheduler );
+
+    while ( ( bytes = fread( records, 1, sizeof( records ), file ) ) > 0 )
+    {
+        size_t i; /* offset of the current record */
+
+        for ( i = 0; i + LS_IMPORT_RECORD_SIZE <= bytes; i += LS_IMPORT_RECORD_SIZE )
+        {
+            const unsigned char *record = &records[ i ];
+            int status = LS_BAD_ROW;
+
+            row++;
+
+            /* the reserved byte is always 0 */
+            if ( record[ 3 ] == 0 )
+            {
+                status = scheduleRow( scheduler,
+                                      ( record[ 2 ] >> 7 ) & 1,                         /* bit 23 */
+                                      record[ 1 ] >> 3,                                 /* bits 11 to 15 */
+                                      ( Days ) ( record[ 2 ] & 0x7f ),                               /* bits 16 to 22 */
+                                      record[ 0 ] | ( ( record[ 1 ] & 0x07 ) << 8 ) );  /* bits 0 to 10 */
+            }
+
+            if ( status == LS_OK )
+                imported++;
+            else
+                reportError( onError, context, row, status );
+        }
+
+        /* a partial record can only be the end of a truncated file */
+        if ( bytes % LS_IMPORT_RECORD_SIZE != 0 )
+        {
+            reportError( onError, context, row + 1, LS_BAD_ROW );
+        }
+    }
+
+    LightScheduler_EndBatch( scheduler );
+    fclose( file );
+
+    return imported;
+}
+
+void LightSchedulerImport_EncodeRecord( int turnOn, int id, Days days, int minuteOfDay, unsigned char *record )
+{
+    /* every value is cut down to the bits of its field */
+    record[ 0 ] = ( unsigned char ) ( minuteOfDay & 0xff );
+    record[ 1 ] = ( unsigned char ) ( ( ( minuteOfDay >> 8 ) & 0x07 ) | ( ( id & 0x1f ) << 3 ) );
+    record[ 2 ] = ( unsigned char ) ( ( days & 0x7f ) | ( turnOn ? 0x80 : 0 ) );
+    record[ 3 ] = 0;
+}
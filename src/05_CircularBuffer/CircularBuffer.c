@@ -8,36 +8,38 @@
  */
 
 #include "CircularBuffer.h"
+#include "CircularBufferPrivate.h"
 #include <Utils.h>
 #include <stdlib.h>
 
-/* structure data type to hold a circular buffer that stores integer values */
-typedef struct CircularBufferStruct
-{
-    int count;    /* number of elements currently stored in the circular buffer (maximum value is limited by 'capacity') */
-    int index;    /* "pointer" to the next location to store a value in the circular buffer */
-    int outdex;   /* "pointer" to the next location to read a value from the circular buffer */
-    int capacity; /* circular buffer capacity (i.e. number of elements it can store) */
-    int *values;  /* array/elements of the circular buffer */
-} CircularBufferStruct;
-
 enum { BUFFER_GUARD = -999 }; /* circular buffer delimiter */
 
-CircularBuffer CircularBuffer_Create( int capacity )
+void CircularBuffer_Init( CircularBuffer self, int *values, int capacity )
 {
-    /* Allocate (dynamically) a block of memory to store the circular buffer
-       and initialize it to zero */
-    CircularBuffer self = calloc( capacity, sizeof( CircularBufferStruct ) );
+    /* the circular buffer starts empty */
+    self->count  = 0;
+    self->index  = 0;
+    self->outdex = 0;
 
     /* Define circular's buffer capacity */
     self->capacity = capacity;
 
-    /* Allocate (dynamically) an array of integers to hold the circular buffer's values
-       and initialize all of them to zero */
-    self->values = calloc( capacity + 1, sizeof( int ) );
+    /* use the provided array (it must hold capacity + 1 integers) to store the circular buffer's values */
+    self->values = values;
 
     /* delimit the circular buffer */
     self->values[ capacity ] = BUFFER_GUARD;
+}
+
+CircularBuffer CircularBuffer_Create( int capacity )
+{
+    /* Allocate (dynamically) a block of memory to store the circular buffer
+       and initialize it to zero */
+    CircularBuffer self = calloc( 1, sizeof( CircularBufferStruct ) );
+
+    /* Allocate (dynamically) an array of integers to hold the circular buffer's values
+       and initialize all of them to zero, then set up the circular buffer to use it */
+    CircularBuffer_Init( self, calloc( capacity + 1, sizeof( int ) ), capacity );
 
     /* return the address of the recently allocated circular buffer */
     return self;
@@ -108,6 +110,18 @@ int CircularBuffer_Get( CircularBuffer self )
     return value;
 }
 
+int CircularBuffer_IsEmpty( CircularBuffer self )
+{
+    /* CircularBuffer_Get() returns 0 both for an empty circular buffer and for a stored 0,
+       so callers that need to tell those cases apart have to ask first */
+    return ( self->count <= 0 );
+}
+
+int CircularBuffer_IsFull( CircularBuffer self )
+{
+    /* same reasoning as CircularBuffer_IsEmpty(), but for CircularBuffer_Put() */
+    return ( self->count >= self->capacity );
+}
 
 void CircularBuffer_Print( CircularBuffer self )
 {
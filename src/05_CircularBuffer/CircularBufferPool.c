@@ -0,0 +1,222 @@
+/**
+ * @file    CircularBufferPool.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Circular Buffer Pool module source file that implements the functions for the Circular Buffer Pool module.
+ *
+ *          Every CircularBuffer_Create()/CircularBuffer_Destroy() pair costs two calloc()/free() round trips.
+ *          When many short-lived circular buffers are needed, the pool hands them out from pre-allocated slabs instead.
+ *
+ *          The pool is made of capacity classes (e.g. 8, 64 and 512 values). Each class owns:
+ *          - a list of slabs, every slab is a single allocation holding 'buffersPerSlab' slots
+ *          - a free list linking the slots that are not in use
+ *          A slot holds a circular buffer structure followed by its array of values, so acquiring or releasing
+ *          a circular buffer is just popping or pushing a slot from/to the free list (O(1), no allocator involved).
+ *          Only when a free list runs out a new slab is allocated for that class.
+ *
+ *          Notes:
+ *          - a circular buffer acquired from the pool must be given back with CircularBufferPool_Release(),
+ *            never with CircularBuffer_Destroy()
+ *          - the pool is not thread-safe, use one pool per thread
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "CircularBufferPool.h"
+#include "CircularBufferPrivate.h"
+#include <stdlib.h>
+#include <stddef.h>
+
+typedef struct PoolClass PoolClass;
+
+/* slot header, the circular buffer values array follows it in memory */
+typedef struct PoolSlot
+{
+    PoolClass *owner;            /* capacity class the slot belongs to */
+    struct PoolSlot *next;       /* next free slot (only meaningful while the slot is in the free list) */
+    CircularBufferStruct buffer; /* circular buffer handed out to the user */
+} PoolSlot;
+
+/* slab header, the slots follow it in memory */
+typedef struct PoolSlab
+{
+    struct PoolSlab *next; /* next slab of the same capacity class */
+} PoolSlab;
+
+/* capacity class: all its slots can hold circular buffers of up to 'capacity' values */
+struct PoolClass
+{
+    int capacity;       /* maximum circular buffer capacity served by the class */
+    size_t slotSize;    /* size (in bytes) of a slot: header plus capacity + 1 values, rounded up for alignment */
+    PoolSlot *freeList; /* slots ready to be acquired */
+    PoolSlab *slabs;    /* slabs allocated so far */
+};
+
+/* structure data type to hold a pool of circular buffers */
+typedef struct CircularBufferPoolStruct
+{
+    int classCount;     /* number of capacity classes */
+    int buffersPerSlab; /* number of slots allocated at once for a capacity class */
+    PoolClass *classes; /* capacity classes, sorted from the smallest to the largest capacity */
+} CircularBufferPoolStruct;
+
+/* every slot (and therefore every slab) has to keep the slot header properly aligned */
+enum { SLOT_ALIGNMENT = sizeof( void * ) };
+
+static int *slotValues( PoolSlot *slot )
+{
+    /* the values array starts right after the slot header */
+    return ( int * ) ( slot + 1 );
+}
+
+static PoolSlot *slotAt( PoolSlab *slab, PoolClass *poolClass, int i )
+{
+    /* the slots start right after the slab header */
+    return ( PoolSlot * ) ( ( char * ) ( slab + 1 ) + ( size_t ) i * poolClass->slotSize );
+}
+
+static int addSlab( PoolClass *poolClass, int buffersPerSlab )
+{
+    int i; /* slot index */
+
+    /* one allocation for the slab header and all of its slots */
+    PoolSlab *slab = malloc( sizeof( PoolSlab ) + ( size_t ) buffersPerSlab * poolClass->slotSize );
+
+    if ( slab == NULL )
+    {
+        return 0;
+    }
+
+    /* keep track of the slab so it can be freed by CircularBufferPool_Destroy() */
+    slab->next = poolClass->slabs;
+    poolClass->slabs = slab;
+
+    /* push every slot of the new slab into the free list */
+    for ( i = 0; i < buffersPerSlab; i++ )
+    {
+        PoolSlot *slot = slotAt( slab, poolClass, i );
+
+        slot->owner = poolClass;
+        slot->next  = poolClass->freeList;
+        poolClass->freeList = slot;
+    }
+
+    return 1;
+}
+
+static PoolClass *findClass( CircularBufferPool self, int capacity )
+{
+    int i; /* capacity class index */
+
+    /* the classes are sorted, so the first one big enough is also the one that wastes the least memory */
+    for ( i = 0; i < self->classCount; i++ )
+    {
+        if ( self->classes[ i ].capacity >= capacity )
+        {
+            return &self->classes[ i ];
+        }
+    }
+
+    /* no capacity class can hold a circular buffer that big */
+    return NULL;
+}
+
+CircularBufferPool CircularBufferPool_Create( const int *capacities, int classCount, int buffersPerSlab )
+{
+    int i, j; /* capacity class indexes */
+
+    /* Allocate (dynamically) the pool and its capacity classes and initialize them to zero */
+    CircularBufferPool self = calloc( 1, sizeof( CircularBufferPoolStruct ) );
+    self->classes = calloc( classCount, sizeof( PoolClass ) );
+
+    self->classCount     = classCount;
+    self->buffersPerSlab = buffersPerSlab;
+
+    /* insert every capacity into its sorted position (there are only a handful of classes) */
+    for ( i = 0; i < classCount; i++ )
+    {
+        for ( j = i; ( j > 0 ) && ( self->classes[ j - 1 ].capacity > capacities[ i ] ); j-- )
+        {
+            self->classes[ j ] = self->classes[ j - 1 ];
+        }
+
+        self->classes[ j ].capacity = capacities[ i ];
+    }
+
+    /* size the slots of every class and pre-allocate their first slab */
+    for ( i = 0; i < classCount; i++ )
+    {
+        PoolClass *poolClass = &self->classes[ i ];
+
+        poolClass->slotSize  = sizeof( PoolSlot ) + ( poolClass->capacity + 1 ) * sizeof( int );
+        poolClass->slotSize  = ( poolClass->slotSize + SLOT_ALIGNMENT - 1 ) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+        addSlab( poolClass, buffersPerSlab );
+    }
+
+    /* return the address of the recently allocated pool */
+    return self;
+}
+
+void CircularBufferPool_Destroy( CircularBufferPool self )
+{
+    int i; /* capacity class index */
+
+    /* Deallocate all the slabs of every class (this releases every circular buffer they hold) */
+    for ( i = 0; i < self->classCount; i++ )
+    {
+        PoolSlab *slab = self->classes[ i ].slabs;
+
+        while ( slab != NULL )
+        {
+            PoolSlab *next = slab->next;
+
+            free( slab );
+            slab = next;
+        }
+    }
+
+    /* Deallocate the capacity classes and the pool */
+    free( self->classes );
+    free( self );
+}
+
+CircularBuffer CircularBufferPool_Acquire( CircularBufferPool self, int capacity )
+{
+    PoolSlot *slot;
+    PoolClass *poolClass = findClass( self, capacity );
+
+    /* if no capacity class is big enough */
+    if ( poolClass == NULL )
+    {
+        /* fail to acquire a circular buffer */
+        return NULL;
+    }
+
+    /* if the free list ran out, grow the class by one slab */
+    if ( ( poolClass->freeList == NULL ) && !addSlab( poolClass, self->buffersPerSlab ) )
+    {
+        return NULL;
+    }
+
+    /* pop a slot from the free list */
+    slot = poolClass->freeList;
+    poolClass->freeList = slot->next;
+
+    /* set up an empty circular buffer of the requested capacity using the slot's values array */
+    CircularBuffer_Init( &slot->buffer, slotValues( slot ), capacity );
+
+    return &slot->buffer;
+}
+
+void CircularBufferPool_Release( CircularBufferPool self, CircularBuffer buffer )
+{
+    /* get back to the slot that contains the circular buffer */
+    PoolSlot *slot = ( PoolSlot * ) ( ( char * ) buffer - offsetof( PoolSlot, buffer ) );
+
+    ( void ) self;
+
+    /* push the slot into its class free list, so the next acquire reuses it */
+    slot->next = slot->owner->freeList;
+    slot->owner->freeList = slot;
+}
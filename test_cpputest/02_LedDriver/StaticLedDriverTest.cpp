@@ -0,0 +1,115 @@
+/**
+ * @file    StaticLedDriverTest.cpp
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Compile-time specialized Led Driver (StaticLedDriver.h) test file
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+extern "C"
+{
+    /* includes for things with C linkage */
+    #include <stdint.h>
+    #include "RuntimeErrorStub.h"
+}
+
+/* includes for things with C++ linkage */
+#include "StaticLedDriver.h"
+#include "TestHarness.h"
+
+/* the board of the LedDriver tests: 16 LEDs behind a 16-bit register */
+typedef StaticLedDriver< uint16_t, 1, 16 > Board;
+
+/* eight active-low status LEDs, numbered 9 to 16, behind an 8-bit register */
+typedef StaticLedDriver< uint8_t, 9, 16, true > StatusLeds;
+
+/* the bit positions are constants */
+static_assert( Board::bit< 1 >() == 0x0001, "LED 1 is bit 0" );
+static_assert( Board::bit< 16 >() == 0x8000, "LED 16 is bit 15" );
+static_assert( StatusLeds::bit< 9 >() == 0x01, "the first LED of the range is bit 0" );
+
+TEST_GROUP( StaticLedDriver )
+{
+    /* define data accessible to test group members here */
+
+    uint16_t virtualLeds;  /* virtual register of the board */
+    uint8_t statusRegister; /* virtual register of the status LEDs */
+
+    void setup()
+    {
+        /* initialization steps are executed before each TEST */
+
+        /* simulate the LEDs are all turned on during hardware initialization */
+        virtualLeds = 0xffff;
+        statusRegister = 0x00;
+    }
+};
+
+TEST( StaticLedDriver, LedsOffAfterCreate )
+{
+    Board leds( &virtualLeds );
+    StatusLeds status( &statusRegister );
+
+    LONGS_EQUAL( 0x0000, virtualLeds );
+    LONGS_EQUAL( 0xff, statusRegister );
+    CHECK_TRUE( leds.areAllOff() );
+    CHECK_TRUE( status.areAllOff() );
+}
+
+TEST( StaticLedDriver, TurnOnAndOffLiteralLeds )
+{
+    Board leds( &virtualLeds );
+
+    leds.turnOn< 3 >();
+    leds.turnOn< 16 >();
+    LONGS_EQUAL( 0x8004, virtualLeds );
+    CHECK_TRUE( leds.isOn< 16 >() );
+
+    leds.turnOff< 3 >();
+    LONGS_EQUAL( 0x8000, virtualLeds );
+    CHECK_FALSE( leds.isOn< 3 >() );
+}
+
+TEST( StaticLedDriver, ActiveLowLedsAreInverted )
+{
+    StatusLeds status( &statusRegister );
+
+    /* turning on LED 9 pulls bit 0 low */
+    status.turnOn< 9 >();
+    LONGS_EQUAL( 0xfe, statusRegister );
+    CHECK_TRUE( status.isOn< 9 >() );
+
+    status.turnAllOn();
+    LONGS_EQUAL( 0x00, statusRegister );
+    CHECK_TRUE( status.areAllOn() );
+}
+
+TEST( StaticLedDriver, RunTimeLedNumbers )
+{
+    Board leds( &virtualLeds );
+
+    for ( unsigned led = 1; led <= 16; led += 5 )
+    {
+        leds.turnOn( led );
+    }
+
+    LONGS_EQUAL( 0x8421, virtualLeds );
+    CHECK_TRUE( leds.isOn( 11u ) );
+
+    leds.turnOff( 11u );
+    CHECK_FALSE( leds.isOn( 11u ) );
+}
+
+TEST( StaticLedDriver, OutOfBoundsRunTimeLeds )
+{
+    StatusLeds status( &statusRegister );
+
+    status.turnOn( 8u );
+    status.turnOn( 17u );
+
+    LONGS_EQUAL( 0xff, statusRegister );
+    CHECK_FALSE( status.isOn( 8u ) );
+    STRCMP_EQUAL( "LED Driver: out-of-bounds LED", RuntimeErrorStub_GetLastError() );
+    LONGS_EQUAL( 17, RuntimeErrorStub_GetLastParameter() );
+}
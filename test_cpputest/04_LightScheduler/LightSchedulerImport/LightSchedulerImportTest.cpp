@@ -0,0 +1,295 @@
+/**
+ * @file    LightSchedulerImportTest.cpp
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Light Scheduler Import test file (bulk import of CSV and binary schedules)
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+extern "C"
+{
+    /* includes for things with C linkage */
+    #include "LightSchedulerImport.h"
+    #include "LightControllerSpy.h"
+    #include "FakeTimeService.h"
+    #include "common.h"
+    #include <stdio.h>  /* fopen() / fputs() / fwrite() / fclose() */
+    #include <stdlib.h> /* mkstemp() */
+    #include <string.h> /* strcpy() */
+    #include <unistd.h> /* close() / unlink() */
+}
+
+/* includes for things with C++ linkage */
+#include "TestHarness.h"
+
+enum { MAX_ERRORS = 8 };
+
+/* rows reported through the error callback */
+typedef struct
+{
+    int count;
+    long rows[ MAX_ERRORS ];
+    int statuses[ MAX_ERRORS ];
+} ImportErrors;
+
+static void recordError( void *context, long row, int status )
+{
+    ImportErrors *errors = ( ImportErrors * ) context;
+
+    if ( errors->count < MAX_ERRORS )
+    {
+        errors->rows[ errors->count ]     = row;
+        errors->statuses[ errors->count ] = status;
+    }
+
+    errors->count++;
+}
+
+TEST_GROUP( LightSchedulerImport )
+{
+    /* define data accessible to test group members here */
+
+    LightScheduler scheduler; /* light scheduler the files are imported into */
+    ImportErrors errors;      /* rows that were not scheduled */
+    char path[ 32 ];          /* file holding the schedule */
+
+    void setup()
+    {
+        /* initialization steps are executed before each TEST */
+        LightController_Create();
+        scheduler = LightScheduler_Create();
+        memset( &errors, 0, sizeof( errors ) );
+
+        /* create a unique (empty) file for every TEST() */
+        strcpy( path, "/tmp/LightScheduleXXXXXX" );
+        close( mkstemp( path ) );
+    }
+
+    void teardown()
+    {
+        /* clean up steps are executed after each TEST */
+        LightScheduler_Destroy( scheduler );
+        unlink( path );
+    }
+
+    void writeText( const char *text )
+    {
+        FILE *file = fopen( path, "w" );
+
+        fputs( text, file );
+        fclose( file );
+    }
+
+    void writeBytes( const void *bytes, size_t size )
+    {
+        FILE *file = fopen( path, "wb" );
+
+        fwrite( bytes, 1, size, file );
+        fclose( file );
+    }
+
+    void wakeUpAt( int day, int minuteOfDay )
+    {
+        FakeTimeService_SetDay( day );
+        FakeTimeService_SetMinute( minuteOfDay );
+        LightScheduler_WakeUp( scheduler );
+    }
+};
+
+TEST( LightSchedulerImport, CsvRowsAreScheduled )
+{
+    writeText( "# light, days, minute\n"
+               "on, 3, MONDAY|WEDNESDAY, 1200\n"
+               "\n"
+               "off,4,EVERYDAY,1200\r\n"
+               "on, 5, WEEKEND, 600" );
+
+    LONGS_EQUAL( 3, LightSchedulerImport_Csv( scheduler, path, recordError, &errors ) );
+    LONGS_EQUAL( 0, errors.count );
+
+    LightController_On( 4 );
+    wakeUpAt( WEDNESDAY, 1200 );
+    LONGS_EQUAL( LIGHT_ON, LightControllerSpy_GetLightState( 3 ) );
+    LONGS_EQUAL( LIGHT_OFF, LightControllerSpy_GetLightState( 4 ) );
+
+    /* the imported events are found by the light scheduler once the import is over */
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, 5, WEEKEND, 600 ) );
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemoveDays( scheduler, 3, ( Days ) ( DAYS_MONDAY | DAYS_WEDNESDAY ), 1200 ) );
+}
+
+TEST( LightSchedulerImport, CsvErrorsAreReportedPerRow )
+{
+    writeText( "on, 3, MONDAY, 600\n"
+               "on, 3, FUNDAY, 600\n"
+               "dim, 3, MONDAY, 600\n"
+               "on, 32, MONDAY, 600\n"
+               "off, 3, MONDAY, 1440\n"
+               "off, 3, MONDAY, 6OO\n"
+               "off, 4, MONDAY, 600\n" );
+
+    /* the bad rows are skipped, the rest of the file is still imported */
+    LONGS_EQUAL( 2, LightSchedulerImport_Csv( scheduler, path, recordError, &errors ) );
+    LONGS_EQUAL( 5, errors.count );
+
+    LONGS_EQUAL( 2, errors.rows[ 0 ] );
+    LONGS_EQUAL( LS_BAD_ROW, errors.statuses[ 0 ] );
+    LONGS_EQUAL( 3, errors.rows[ 1 ] );
+    LONGS_EQUAL( LS_BAD_ROW, errors.statuses[ 1 ] );
+    LONGS_EQUAL( 4, errors.rows[ 2 ] );
+    LONGS_EQUAL( LS_ID_OUT_OF_BOUNDS, errors.statuses[ 2 ] );
+    LONGS_EQUAL( 5, errors.rows[ 3 ] );
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, errors.statuses[ 3 ] );
+    LONGS_EQUAL( 6, errors.rows[ 4 ] );
+    LONGS_EQUAL( LS_BAD_ROW, errors.statuses[ 4 ] );
+}
+
+TEST( LightSchedulerImport, CsvLineTooLongIsABadRow )
+{
+    char text[ 300 ];
+
+    /* a 200 characters comment, then a valid row */
+    memset( text, '#', 200 );
+    strcpy( &text[ 200 ], "\non, 3, MONDAY, 600\n" );
+    writeText( text );
+
+    LONGS_EQUAL( 1, LightSchedulerImport_Csv( scheduler, path, recordError, &errors ) );
+    LONGS_EQUAL( 1, errors.count );
+    LONGS_EQUAL( 1, errors.rows[ 0 ] );
+}
+
+TEST( LightSchedulerImport, CsvLongestLineIsARow )
+{
+    char text[ 300 ];
+
+    /* a 128 characters row (padded with blanks), then the same row one character longer */
+    memset( text, ' ', sizeof( text ) );
+    memcpy( &text[ 0 ], "on, 3, MONDAY, 600", 18 );
+    text[ 128 ] = '\n';
+    memcpy( &text[ 129 ], "on, 4, MONDAY, 600", 18 );
+    text[ 129 + 129 ] = '\n';
+    text[ 129 + 130 ] = '\0';
+    writeText( text );
+
+    LONGS_EQUAL( 1, LightSchedulerImport_Csv( scheduler, path, recordError, &errors ) );
+    LONGS_EQUAL( 1, errors.count );
+    LONGS_EQUAL( 2, errors.rows[ 0 ] );
+    LONGS_EQUAL( LS_BAD_ROW, errors.statuses[ 0 ] );
+}
+
+TEST( LightSchedulerImport, BinaryRecordsAreScheduled )
+{
+    unsigned char file[ LS_IMPORT_MAGIC_SIZE + 3 * LS_IMPORT_RECORD_SIZE ];
+
+    memcpy( file, LS_IMPORT_MAGIC, LS_IMPORT_MAGIC_SIZE );
+    LightSchedulerImport_EncodeRecord( TRUE, 31, DAYS_FRIDAY, 1439, &file[ 4 ] );
+    LightSchedulerImport_EncodeRecord( FALSE, 0, DAYS_EVERYDAY, 0, &file[ 8 ] );
+    LightSchedulerImport_EncodeRecord( TRUE, 7, DAYS_FRIDAY, 1439, &file[ 12 ] );
+    writeBytes( file, sizeof( file ) );
+
+    LONGS_EQUAL( 3, LightSchedulerImport_Binary( scheduler, path, recordError, &errors ) );
+    LONGS_EQUAL( 0, errors.count );
+
+    wakeUpAt( FRIDAY, 1439 );
+    LONGS_EQUAL( LIGHT_ON, LightControllerSpy_GetLightState( 31 ) );
+    LONGS_EQUAL( LIGHT_ON, LightControllerSpy_GetLightState( 7 ) );
+
+    wakeUpAt( SATURDAY, 0 );
+    LONGS_EQUAL( LIGHT_OFF, LightControllerSpy_GetLightState( 0 ) );
+}
+
+TEST( LightSchedulerImport, BinaryErrorsAreReportedPerRecord )
+{
+    unsigned char file[ LS_IMPORT_MAGIC_SIZE + 3 * LS_IMPORT_RECORD_SIZE + 2 ];
+
+    memcpy( file, LS_IMPORT_MAGIC, LS_IMPORT_MAGIC_SIZE );
+    LightSchedulerImport_EncodeRecord( TRUE, 3, DAYS_MONDAY, 1500, &file[ 4 ] );
+    LightSchedulerImport_EncodeRecord( TRUE, 3, DAYS_MONDAY, 600, &file[ 8 ] );
+    LightSchedulerImport_EncodeRecord( TRUE, 3, DAYS_MONDAY, 600, &file[ 12 ] );
+    file[ 15 ] = 0xff;
+
+    /* the file ends in the middle of a fourth record */
+    writeBytes( file, sizeof( file ) );
+
+    LONGS_EQUAL( 1, LightSchedulerImport_Binary( scheduler, path, recordError, &errors ) );
+    LONGS_EQUAL( 3, errors.count );
+    LONGS_EQUAL( 1, errors.rows[ 0 ] );
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, errors.statuses[ 0 ] );
+    LONGS_EQUAL( 3, errors.rows[ 1 ] );
+    LONGS_EQUAL( LS_BAD_ROW, errors.statuses[ 1 ] );
+    LONGS_EQUAL( 4, errors.rows[ 2 ] );
+    LONGS_EQUAL( LS_BAD_ROW, errors.statuses[ 2 ] );
+}
+
+TEST( LightSchedulerImport, BinaryRecordWithoutDaysIsRejected )
+{
+    unsigned char file[ LS_IMPORT_MAGIC_SIZE + 2 * LS_IMPORT_RECORD_SIZE ];
+
+    memcpy( file, LS_IMPORT_MAGIC, LS_IMPORT_MAGIC_SIZE );
+    LightSchedulerImport_EncodeRecord( TRUE, 3, DAYS_NONE, 600, &file[ 4 ] );
+    LightSchedulerImport_EncodeRecord( TRUE, 4, DAYS_MONDAY, 600, &file[ 8 ] );
+    writeBytes( file, sizeof( file ) );
+
+    /* a record with days = 0 is reported, not scheduled */
+    LONGS_EQUAL( 1, LightSchedulerImport_Binary( scheduler, path, recordError, &errors ) );
+    LONGS_EQUAL( 1, errors.count );
+    LONGS_EQUAL( 1, errors.rows[ 0 ] );
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, errors.statuses[ 0 ] );
+}
+
+TEST( LightSchedulerImport, FilesThatCannotBeImported )
+{
+    LONGS_EQUAL( LS_IMPORT_FAILED, LightSchedulerImport_Csv( scheduler, "/nonexistent/schedule.csv", NULL, NULL ) );
+    LONGS_EQUAL( LS_IMPORT_FAILED, LightSchedulerImport_Binary( scheduler, "/nonexistent/schedule.bin", NULL, NULL ) );
+
+    /* a CSV file is not a binary schedule */
+    writeText( "on, 3, MONDAY, 600\n" );
+    LONGS_EQUAL( LS_IMPORT_FAILED, LightSchedulerImport_Binary( scheduler, path, NULL, NULL ) );
+}
+
+TEST( LightSchedulerImport, LargeImportGrowsTheSchedule )
+{
+    enum { EVENTS = 5000 };
+
+    FILE *file = fopen( path, "w" );
+    int i;
+
+    for ( i = 0; i < EVENTS; i++ )
+    {
+        fprintf( file, "%s, %d, WEEKDAY, %d\n", ( i % 2 ) ? "on" : "off", i % 32, i % 1440 );
+    }
+
+    fclose( file );
+
+    /* a tickless light scheduler arms its alarm for the first event when the import ends */
+    FakeTimeService_SetDay( MONDAY );
+    FakeTimeService_SetMinute( 0 );
+    LightScheduler_SetTickless( scheduler, TRUE );
+
+    LONGS_EQUAL( EVENTS, LightSchedulerImport_Csv( scheduler, path, NULL, NULL ) );
+    LONGS_EQUAL( 1440 + 0, LightScheduler_NextDue( scheduler ) );
+    LONGS_EQUAL( 0, FakeTimeService_GetOneShotAlarmInSeconds() );
+
+    /* every event can be removed */
+    for ( i = 0; i < EVENTS; i++ )
+    {
+        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, i % 32, WEEKDAY, i % 1440 ) );
+    }
+}
+
+TEST( LightSchedulerImport, ImportInsideABatch )
+{
+    writeText( "on, 3, MONDAY, 600\n" );
+
+    FakeTimeService_SetDay( MONDAY );
+    FakeTimeService_SetMinute( 590 );
+    LightScheduler_SetTickless( scheduler, TRUE );
+
+    /* the import does not end the batch it is part of */
+    LightScheduler_BeginBatch( scheduler );
+    LONGS_EQUAL( 1, LightSchedulerImport_Csv( scheduler, path, NULL, NULL ) );
+    LONGS_EQUAL( TIME_UNKNOWN, FakeTimeService_GetOneShotAlarmInSeconds() );
+
+    LightScheduler_EndBatch( scheduler );
+    LONGS_EQUAL( 10 * 60, FakeTimeService_GetOneShotAlarmInSeconds() );
+}
@@ -13,6 +13,7 @@ extern "C"
     #include "FakeRandomMinute.h"
     #include "LightScheduler.h"
     #include "FakeTimeService.h"
+    #include "common.h"
     #include "LightControllerSpy.h"
 }
 
@@ -22,12 +23,14 @@ extern "C"
 TEST_GROUP( LightSchedulerRandomize )
 {
     /* define data accessible to test group members here */
+
+    LightScheduler scheduler; /* light scheduler under test */
       
     void setup()
     {
         /* initialization steps are executed before each TEST */
         LightController_Create();
-        LightScheduler_Create();
+        scheduler = LightScheduler_Create();
 
         /* Function pointer restoration is so common that CppUTest has a built-in macro for setting
            and restoring function pointers.
@@ -43,6 +46,7 @@ TEST_GROUP( LightSchedulerRandomize )
     void teardown()
     {
         /* clean up steps are executed after each TEST */
+        LightScheduler_Destroy( scheduler );
     }
 
     /* Repeated operations and checks can be extracted into helper functions,
@@ -88,7 +92,7 @@ TEST( LightSchedulerRandomize, TurnsOnEarly )
 
     /* Schedule light ID 4 to turn on everyday at minute 600 (10am).
        Randomization of the scheduled event is disabled by default */
-    LightScheduler_ScheduleTurnOn( 4, EVERYDAY, 600 );
+    LightScheduler_ScheduleTurnOn( scheduler, 4, EVERYDAY, 600 );
 
     /* Enable randomization of the next scheduled event:
        - light ID 4
@@ -101,7 +105,7 @@ TEST( LightSchedulerRandomize, TurnsOnEarly )
 
        In this case since we are using a fake random minute generator (RandomMinute_Get function pointer points to the fake double),
        then we have control over the values returned by RandomMinute_Get() thanks to FakeRandomMinute_SetFirstAndIncrement() */
-    LightScheduler_Randomize( 4, EVERYDAY, 600 );
+    LightScheduler_Randomize( scheduler, 4, EVERYDAY, 600 );
 
     /* Set 600 - 10 (9:50 am) as the current minute of the day and Monday as the current day of the week.
        -10 is the start random minute to be generated by the fake RandomMinute_Get(), was set by FakeRandomMinute_SetFirstAndIncrement(),
@@ -114,7 +118,7 @@ TEST( LightSchedulerRandomize, TurnsOnEarly )
 
     /* The test simulates a callback to LightScheduler_WakeUp(), like the production TimeService
        would do every minute */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* Finally the test checks the expected outcome.
     
@@ -122,3 +126,90 @@ TEST( LightSchedulerRandomize, TurnsOnEarly )
        then light ID should be 4 and state should be ON */
     checkLightState( 4, LIGHT_ON );
 }
+
+TEST( LightSchedulerRandomize, RandomizedEventMovesToItsNewMinute )
+{
+    /* -10 is the first random offset, -5 the second one */
+    FakeRandomMinute_SetFirstAndIncrement( -10, 5 );
+
+    LightScheduler_ScheduleTurnOn( scheduler, 4, EVERYDAY, 600 );
+    LightScheduler_Randomize( scheduler, 4, EVERYDAY, 600 );
+
+    /* the event fires at 9:50 am on monday, and gets a new random offset (-5) */
+    setTimeTo( MONDAY, 600 - 10 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_ON );
+
+    /* the event is no longer in the 9:50 am bucket of tuesday ... */
+    LightController_Create();
+    setTimeTo( TUESDAY, 600 - 10 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_STATE_UNKNOWN );
+
+    /* ... it has been moved to the 9:55 am one */
+    setTimeTo( TUESDAY, 600 - 5 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_ON );
+}
+
+TEST( LightSchedulerRandomize, CompiledScheduleRerollsRandomizedEvents )
+{
+    /* -10 is the first random offset, -5 the second one */
+    FakeRandomMinute_SetFirstAndIncrement( -10, 5 );
+
+    LightScheduler_SetCompiled( scheduler, TRUE );
+    LightScheduler_ScheduleTurnOn( scheduler, 4, EVERYDAY, 600 );
+    LightScheduler_Randomize( scheduler, 4, EVERYDAY, 600 );
+
+    setTimeTo( MONDAY, 600 - 10 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_ON );
+
+    /* the compiled schedule follows the new random offset */
+    LightController_Create();
+    setTimeTo( TUESDAY, 600 - 10 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_STATE_UNKNOWN );
+
+    setTimeTo( TUESDAY, 600 - 5 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_ON );
+}
+
+TEST( LightSchedulerRandomize, RandomizesEveryMatchingEvent )
+{
+    /* -10 is the first random offset, -5 the second one */
+    FakeRandomMinute_SetFirstAndIncrement( -10, 5 );
+
+    /* two events share the same light ID, day and minute */
+    LightScheduler_ScheduleTurnOn( scheduler, 4, EVERYDAY, 600 );
+    LightScheduler_ScheduleTurnOff( scheduler, 4, EVERYDAY, 600 );
+    LightScheduler_Randomize( scheduler, 4, EVERYDAY, 600 );
+
+    /* the first one got -10 ... */
+    setTimeTo( MONDAY, 600 - 10 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_ON );
+
+    /* ... and the second one -5 */
+    setTimeTo( MONDAY, 600 - 5 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 4, LIGHT_OFF );
+}
+
+TEST( LightSchedulerRandomize, PackedEventsKeepTheirFields )
+{
+    /* the highest light ID, the last minute of the day and the widest offset that still lands on the day */
+    FakeRandomMinute_SetFirstAndIncrement( -1439, 0 );
+
+    LightScheduler_ScheduleTurnOff( scheduler, 31, SATURDAY, 1439 );
+    LightScheduler_Randomize( scheduler, 31, SATURDAY, 1439 );
+
+    LightController_On( 31 );
+    setTimeTo( SATURDAY, 0 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 31, LIGHT_OFF );
+
+    /* the event is still found by its scheduled time */
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, 31, SATURDAY, 1439 ) );
+}
@@ -30,6 +30,7 @@ extern "C"
     #include "LightScheduler.h"
     #include "LightControllerSpy.h"
     #include "FakeTimeService.h"
+    #include "common.h"
 }
 
 /* includes for things with C++ linkage */
@@ -99,23 +100,33 @@ TEST( LightSchedulerInitAndCleanup, CreateStartsOneMinuteAlarm )
     /* Initialize the Light Scheduler.
        Upon initialization:
        - there will be no scheduled lights to be turned on/off
-       - LightScheduler_WakeUp() will be registered as the alarm callback to be "called" every minute */
-    LightScheduler_Create();
+       - an alarm callback that wakes this light scheduler up will be registered to be "called" every minute */
+    LightScheduler scheduler = LightScheduler_Create();
 
-    /* check the expected outcome, the registered alarm callback is LightScheduler_WakeUp()
-       with a one minute period */
-    POINTERS_EQUAL( ( void* ) LightScheduler_WakeUp, ( void* ) FakeTimeService_GetAlarmCallback() );
+    /* check the expected outcome, the alarm is registered with a one minute period
+       and the light scheduler as its context */
+    CHECK( FakeTimeService_GetAlarmCallback() != NULL );
+    POINTERS_EQUAL( scheduler, FakeTimeService_GetAlarmContext() );
     LONGS_EQUAL( 60, FakeTimeSource_GetAlarmPeriodInSeconds() );
+
+    /* firing the alarm wakes the light scheduler up */
+    LightController_Create();
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 1200 );
+    setTimeTo( MONDAY, 1200 );
+    FakeTimeService_GetAlarmCallback()( FakeTimeService_GetAlarmContext() );
+    checkLightState( 3, LIGHT_ON );
+
+    LightScheduler_Destroy( scheduler );
 }
 
 TEST( LightSchedulerInitAndCleanup, DestroyCancelsOneMinuteAlarm )
 {
     /* This test assures LightScheduler_Destroy() cancels the periodic alarm
        registered during the Light Scheduler initialization with LightScheduler_Create() */
-    LightScheduler_Create();
+    LightScheduler scheduler = LightScheduler_Create();
 
     /* "destroy" the periodic alarm */
-    LightScheduler_Destroy();
+    LightScheduler_Destroy( scheduler );
 
     /* check the expected outcome, there's no registered alarm callback and period is 0 */
     POINTERS_EQUAL( NULL, ( void* ) FakeTimeService_GetAlarmCallback() );
@@ -127,18 +138,20 @@ TEST( LightSchedulerInitAndCleanup, DestroyCancelsOneMinuteAlarm )
 TEST_GROUP( LightScheduler )
 {
     /* define data accessible to test group members here */
+
+    LightScheduler scheduler; /* light scheduler under test */
  
     void setup()
     {
         /* initialization steps are executed before each TEST */ 
-        LightScheduler_Create();
+        scheduler = LightScheduler_Create();
         LightController_Create();
     }
  
     void teardown()
     {
         /* clean up steps are executed after each TEST */
-        LightScheduler_Destroy();
+        LightScheduler_Destroy( scheduler );
     }
 };
 
@@ -181,7 +194,7 @@ TEST( LightScheduler, NoScheduleNothingHappens )
 
     /* The test simulates a callback to LightScheduler_WakeUp(), like the production TimeService
        would do every minute */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* Since no light ID and state have been scheduled, the expected light ID and state
        have to be unknown due to the Light Scheduler's initialization (i.e. Light Controller's
@@ -197,7 +210,7 @@ TEST( LightScheduler, ScheduleOnEverydayNotTimeYet )
 
     /* The test schedules the light with ID 3 to turn ON everyday at the 1200th minute
        (i.e. 1200mins / (60mins / 1hr) = 20hrs = 8pm) */
-    LightScheduler_ScheduleTurnOn( 3, EVERYDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, EVERYDAY, 1200 );
 
     /* The test takes control of the clock, telling the Fake Time Source (Fake Time Service) that it
        should report that it's MONDAY at 7:59pm (one minute before the scheduled time above for the
@@ -206,7 +219,7 @@ TEST( LightScheduler, ScheduleOnEverydayNotTimeYet )
 
     /* The test simulates a callback to LightScheduler_WakeUp(), like the production TimeService
        would do every minute */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* Finally the test checks the expected outcome (since the time for the scheduled light ID has
        not been reached, then both light ID and state are still unknown, due to the initial state
@@ -222,7 +235,7 @@ TEST( LightScheduler, ScheduleOnEverydayItsTime )
 
     /* The test schedules the light with ID 3 to turn ON everyday at the 1200th minute
        (i.e. 1200mins / (60mins / 1hr) = 20hrs = 8pm) */
-    LightScheduler_ScheduleTurnOn( 3, EVERYDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, EVERYDAY, 1200 );
 
     /* The test takes control of the clock, telling the Fake Time Source (Fake Time Service) that it
        should report that it's MONDAY at 8:00pm (the exact time as scheduled above for the
@@ -231,7 +244,7 @@ TEST( LightScheduler, ScheduleOnEverydayItsTime )
 
     /* The test simulates a callback to LightScheduler_WakeUp(), like the production TimeService
        would do every minute */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
  
     /* Finally the test checks the expected outcome (the time for the scheduled light ID has been reached,
        then light ID should be 3 and state should be ON)  */
@@ -246,7 +259,7 @@ TEST( LightScheduler, ScheduleOffEverydayItsTime )
 
     /* The test schedules the light with ID 3 to turn OFF everyday at the 1200th minute
        (i.e. 1200mins / (60mins / 1hr) = 20hrs = 8pm) */
-    LightScheduler_ScheduleTurnOff( 3, EVERYDAY, 1200 );
+    LightScheduler_ScheduleTurnOff( scheduler, 3, EVERYDAY, 1200 );
 
     /* The test takes control of the clock, telling the Fake Time Source (Fake Time Service) that it
        should report that it's MONDAY at 8:00pm (the exact time as scheduled above for the
@@ -255,7 +268,7 @@ TEST( LightScheduler, ScheduleOffEverydayItsTime )
 
     /* The test simulates a callback to LightScheduler_WakeUp(), like the production TimeService
        would do every minute */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* Finally the test checks the expected outcome (the time for the scheduled light ID has been reached,
        then light ID should be 3 and state should be OFF)  */
@@ -269,14 +282,14 @@ TEST( LightScheduler, ScheduleWeekendItsMonday )
        and last scheduled light state as unknowns) */
 
     /* schedule light with ID 3 to turn on on weekends (saturdays and sundays) at minute 1200 (8pm)*/
-    LightScheduler_ScheduleTurnOn( 3, WEEKEND, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEEKEND, 1200 );
 
     /* set the current (fake) time to monday 8pm */
     setTimeTo( MONDAY, 1200 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID and its state, they should be unknowns because the scheduled event
        has not been reached (scheduled a light on on weekends for 8pm, but its currently monday 8pm,
@@ -291,14 +304,14 @@ TEST( LightScheduler, ScheduleTuesdayButItsMonday )
        and last scheduled light state as unknowns) */
 
     /* schedule light with ID 3 to turn on on TUESDAY at minute 1200 (8pm)*/
-    LightScheduler_ScheduleTurnOn( 3, TUESDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, TUESDAY, 1200 );
 
     /* set the current (fake) time to monday 8pm */
     setTimeTo( MONDAY, 1200 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID and its state, they should be unknowns because the scheduled event
        has not been reached (scheduled a light on on tuesdays for 8pm, but its currently monday 8pm,
@@ -313,14 +326,14 @@ TEST( LightScheduler, ScheduleTuesdayAndItsTuesday )
        and last scheduled light state as unknowns) */
 
     /* schedule light with ID 3 to turn on on TUESDAY at minute 1200 (8pm)*/
-    LightScheduler_ScheduleTurnOn( 3, TUESDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, TUESDAY, 1200 );
 
     /* set the current (fake) time to TUESDAY 8pm */
     setTimeTo( TUESDAY, 1200 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID and its state, they should be light ID 3 and light state on because the
        scheduled event has been reached (scheduled light ID 3 on on tuesdays for 8pm. Currently it's tuesday 8pm,
@@ -335,14 +348,14 @@ TEST( LightScheduler, ScheduleWeekendItsFriday )
        and last scheduled light state as unknowns) */
 
     /* schedule light with ID 3 to turn on on weekends (saturdays and sundays) at minute 1200 (8pm)*/
-    LightScheduler_ScheduleTurnOn( 3, WEEKEND, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEEKEND, 1200 );
 
     /* set the current (fake) time to friday 8pm */
     setTimeTo( FRIDAY, 1200 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID and its state, they should be unknowns because the scheduled event
        has not been reached (scheduled a light on on weekends, i.e. saturdays and sundays for 8pm,
@@ -357,14 +370,14 @@ TEST( LightScheduler, ScheduleWeekendItsSaturday )
        and last scheduled light state as unknowns) */
 
     /* schedule light with ID 3 to turn on on weekends (saturdays and sundays) at minute 1200 (8pm)*/
-    LightScheduler_ScheduleTurnOn( 3, WEEKEND, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEEKEND, 1200 );
 
     /* set the current (fake) time to saturday 8pm */
     setTimeTo( SATURDAY, 1200 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID and its state, they should be light ID 3 and light state on because the
        scheduled event has been reached (scheduled light ID 3 on on weekends (saturdays and sundays) for 8pm.
@@ -379,14 +392,14 @@ TEST( LightScheduler, ScheduleWeekendItsSunday )
        and last scheduled light state as unknowns) */
 
     /* schedule light with ID 3 to turn on on weekends (saturdays and sundays) at minute 1200 (8pm)*/
-    LightScheduler_ScheduleTurnOn( 3, WEEKEND, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEEKEND, 1200 );
 
     /* set the current (fake) time to sunday 8pm */
     setTimeTo( SUNDAY, 1200 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID and its state, they should be light ID 3 and light state on because the
        scheduled event has been reached (scheduled light ID 3 on on weekends (saturdays and sundays) for 8pm.
@@ -402,18 +415,18 @@ TEST( LightScheduler, ScheduleTwoEventsAtTheSameTime )
 
     /* Schedule light with ID 3 to turn on on sunday at minute 1200 (8pm).
        This will use a slot from the scheduledEvents[] array */
-    LightScheduler_ScheduleTurnOn( 3, SUNDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, SUNDAY, 1200 );
 
     /* Schedule light with ID 12 to turn on on sunday at minute 1200 (8pm).
        This will use a slot from the scheduledEvents[] array */
-    LightScheduler_ScheduleTurnOn( 12, SUNDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 12, SUNDAY, 1200 );
 
     /* set the current (fake) time to sunday 8pm */
     setTimeTo( SUNDAY, 1200 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID(s)) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID and its state, they should be light ID 3 and light state on because the
        scheduled event has been reached (scheduled light ID 3 on on sunday for 8pm.
@@ -426,41 +439,140 @@ TEST( LightScheduler, ScheduleTwoEventsAtTheSameTime )
     checkLightState( 12, LIGHT_ON );
 }
 
-TEST( LightScheduler, RejectsTooManyEvents )
+TEST( LightScheduler, ScheduleWeekdayRunsMondayToFriday )
+{
+    int day; /* day of the week */
+
+    /* a WEEKDAY event is linked into the timing wheel bucket of every day from monday to friday */
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEEKDAY, 1200 );
+
+    for ( day = SUNDAY; day <= SATURDAY; day++ )
+    {
+        /* forget the previous day's light changes */
+        LightController_Create();
+
+        setTimeTo( day, 1200 );
+        LightScheduler_WakeUp( scheduler );
+
+        checkLightState( 3, ( ( day == SATURDAY ) || ( day == SUNDAY ) ) ? LIGHT_STATE_UNKNOWN : LIGHT_ON );
+    }
+}
+
+TEST( LightScheduler, RemovedEverydayEventNeverFires )
+{
+    int day; /* day of the week */
+
+    /* removing an EVERYDAY event has to unlink it from the bucket of all seven days */
+    LightScheduler_ScheduleTurnOn( scheduler, 3, EVERYDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 4, EVERYDAY, 1200 );
+    LightScheduler_ScheduleRemove( scheduler, 3, EVERYDAY, 1200 );
+
+    for ( day = SUNDAY; day <= SATURDAY; day++ )
+    {
+        setTimeTo( day, 1200 );
+        LightScheduler_WakeUp( scheduler );
+
+        checkLightState( 3, LIGHT_STATE_UNKNOWN );
+        checkLightState( 4, LIGHT_ON );
+    }
+}
+
+TEST( LightScheduler, CompiledScheduleDrivesTheLights )
+{
+    /* events scheduled before and after compiling the schedule */
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEEKEND, 1200 );
+    LightScheduler_SetCompiled( scheduler, TRUE );
+    LightScheduler_ScheduleTurnOff( scheduler, 12, EVERYDAY, 1200 );
+    LightScheduler_ScheduleTurnOn( scheduler, 31, SATURDAY, 1200 );
+
+    setTimeTo( SATURDAY, 1200 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 3, LIGHT_ON );
+    checkLightState( 12, LIGHT_OFF );
+    checkLightState( 31, LIGHT_ON );
+
+    /* on monday only the everyday event is due */
+    LightController_Create();
+    setTimeTo( MONDAY, 1200 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 3, LIGHT_STATE_UNKNOWN );
+    checkLightState( 12, LIGHT_OFF );
+}
+
+TEST( LightScheduler, CompiledScheduleFollowsRemove )
+{
+    LightScheduler_SetCompiled( scheduler, TRUE );
+
+    LightScheduler_ScheduleTurnOn( scheduler, 6, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOn( scheduler, 7, MONDAY, 600 );
+    LightScheduler_ScheduleRemove( scheduler, 6, MONDAY, 600 );
+
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 6, LIGHT_STATE_UNKNOWN );
+    checkLightState( 7, LIGHT_ON );
+}
+
+TEST( LightScheduler, CompiledScheduleLastEventForALightWins )
+{
+    /* on and off for the same light at the same minute: the event scheduled last wins,
+       like it does when the bucket is walked in order */
+    LightScheduler_ScheduleTurnOn( scheduler, 5, EVERYDAY, 600 );
+    LightScheduler_ScheduleTurnOff( scheduler, 5, EVERYDAY, 600 );
+    LightScheduler_SetCompiled( scheduler, TRUE );
+
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 5, LIGHT_OFF );
+}
+
+TEST( LightScheduler, AcceptsTensOfThousandsOfEvents )
 {
     int i; /* scheduled event index */
 
-    /* for all the possible number of scheduled events (MAX_EVENTS_NUMBER) */
-    for ( i = 0; i < 128; i++ )
+    /* there is no fixed number of scheduled event slots, the storage grows as needed */
+    for ( i = 0; i < 20000; i++ )
     {
         /* schedule a light to turn on */
-        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( 6, MONDAY, 600 + i ) );
+        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, i % 32, ( Day ) ( SUNDAY + i % 7 ), i % 1440 ) );
     }
 
-    /* Schedule a light to turn on. At this point there are no more available scheduled events,
-       so the expected result is too many events */
-    LONGS_EQUAL( LS_TOO_MANY_EVENTS, LightScheduler_ScheduleTurnOn( 6, MONDAY, 600 + i ) );
+    /* the last event scheduled is kept and fires at its time */
+    setTimeTo( SUNDAY + 19999 % 7, 19999 % 1440 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 19999 % 32, LIGHT_ON );
 }
 
 TEST( LightScheduler, RemoveRecyclesScheduledSlot )
 {
     int i; /* scheduled event index */
 
-    /* for all the possible number of scheduled events (MAX_EVENTS_NUMBER) */
+    /* fill up the slots allocated by LightScheduler_Create() */
     for ( i = 0; i < 128; i++ )
     {
         /* schedule a light to turn on */
-        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( 6, MONDAY, 600 + i ) );
+        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 6, MONDAY, 600 + i ) );
     }
 
-    /* At this point there are no more available scheduled events (i.e. too many events) */
-
     /* remove the scheduled light ID 6 to turn on on MONDAY at minite 600 */
-    LightScheduler_ScheduleRemove( 6, MONDAY, 600 );
+    LightScheduler_ScheduleRemove( scheduler, 6, MONDAY, 600 );
+
+    /* Schedule a light to turn on. The slot just freed is reused, so the expected result is OK */
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 13, MONDAY, 1000 ) );
 
-    /* Schedule a light to turn on. This should not be a problem since there is
-       one slot available to schedule this event, so the expected result is OK */
-    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( 13, MONDAY, 1000 ) );
+    /* and the removed event does not come back */
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 6, LIGHT_STATE_UNKNOWN );
+
+    setTimeTo( MONDAY, 1000 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 13, LIGHT_ON );
 }
 
 TEST( LightScheduler, RemoveMultipleScheduledEvent )
@@ -469,20 +581,20 @@ TEST( LightScheduler, RemoveMultipleScheduledEvent )
        (setup() calls LightController_Create() which sets all the light ID states to unknowns) */
     
     /* Schedule light with ID 6 to turn on on monday at 10am */
-    LightScheduler_ScheduleTurnOn( 6, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOn( scheduler, 6, MONDAY, 600 );
 
     /* Schedule light with ID 7 to turn on on monday at 10am */
-    LightScheduler_ScheduleTurnOn( 7, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOn( scheduler, 7, MONDAY, 600 );
     
     /* remove the scheduled light ID 6 to turn on on MONDAY at 10am */
-    LightScheduler_ScheduleRemove( 6, MONDAY, 600 );
+    LightScheduler_ScheduleRemove( scheduler, 6, MONDAY, 600 );
 
     /* set the current (fake) time to monday 10am */
     setTimeTo( MONDAY, 600 );
 
     /* callback to Light Scheduler wakeup (this compares the current time to any scheduled events,
        if there's a match then it will turn on or off the specified light ID(s)) */
-    LightScheduler_WakeUp();
+    LightScheduler_WakeUp( scheduler );
 
     /* compare the light ID 6's state. It should be light state unknown because the
        scheduled event was removed with LightScheduler_ScheduleRemove() */
@@ -493,6 +605,219 @@ TEST( LightScheduler, RemoveMultipleScheduledEvent )
     checkLightState( 7, LIGHT_ON );
 }
 
+TEST( LightScheduler, RemoveTakesOneEventAtATime )
+{
+    /* two identical events, each removal takes only one of them */
+    LightScheduler_ScheduleTurnOn( scheduler, 5, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOn( scheduler, 5, MONDAY, 600 );
+
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, 5, MONDAY, 600 ) );
+
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 5, LIGHT_ON );
+
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, 5, MONDAY, 600 ) );
+    LONGS_EQUAL( LS_EVENT_DOES_NOT_EXIST, LightScheduler_ScheduleRemove( scheduler, 5, MONDAY, 600 ) );
+}
+
+TEST( LightScheduler, RemoveEventsInAnyOrder )
+{
+    enum { EVENTS = 5000 };
+
+    int i; /* scheduled event index */
+
+    /* event i is light i % 8 on day i % 7 at minute i % 1440 (every event has a key of its own) */
+    for ( i = 0; i < EVENTS; i++ )
+    {
+        LightScheduler_ScheduleTurnOn( scheduler, i % 8, ( Day ) ( SUNDAY + i % 7 ), i % 1440 );
+    }
+
+    /* remove the even events in a scrambled order, removals shift the hash table clusters around
+       but every event is still found */
+    for ( i = 0; i < EVENTS; i += 2 )
+    {
+        int event = ( i * 7919 ) % EVENTS;
+
+        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, event % 8, ( Day ) ( SUNDAY + event % 7 ), event % 1440 ) );
+        LONGS_EQUAL( LS_EVENT_DOES_NOT_EXIST,
+                     LightScheduler_ScheduleRemove( scheduler, event % 8, ( Day ) ( SUNDAY + event % 7 ), event % 1440 ) );
+    }
+
+    /* the odd events are all still there */
+    for ( i = 1; i < EVENTS; i += 2 )
+    {
+        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, i % 8, ( Day ) ( SUNDAY + i % 7 ), i % 1440 ) );
+    }
+}
+
+TEST( LightScheduler, InstancesKeepTheirOwnSchedule )
+{
+    /* a second light scheduler (e.g. another home) in the same process */
+    LightScheduler other = LightScheduler_Create();
+
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOn( other, 4, MONDAY, 600 );
+    LightScheduler_ScheduleRemove( other, 3, MONDAY, 600 );
+
+    /* only the events of the light scheduler woken up are due */
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( other );
+
+    checkLightState( 3, LIGHT_STATE_UNKNOWN );
+    checkLightState( 4, LIGHT_ON );
+
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 3, LIGHT_ON );
+
+    LightScheduler_Destroy( other );
+}
+
+TEST( LightScheduler, LateWakeUpCatchesUpMissedMinutes )
+{
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOff( scheduler, 4, MONDAY, 601 );
+
+    /* the wake-ups at 10:00 am and 10:01 am never came */
+    setTimeTo( MONDAY, 599 );
+    LightScheduler_WakeUp( scheduler );
+    setTimeTo( MONDAY, 603 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 3, LIGHT_ON );
+    checkLightState( 4, LIGHT_OFF );
+}
+
+TEST( LightScheduler, CatchUpCrossesTheEndOfTheWeek )
+{
+    /* saturday 11:59 pm and sunday midnight */
+    LightScheduler_ScheduleTurnOn( scheduler, 3, SATURDAY, 1439 );
+    LightScheduler_ScheduleTurnOn( scheduler, 4, SUNDAY, 0 );
+
+    setTimeTo( SATURDAY, 1437 );
+    LightScheduler_WakeUp( scheduler );
+    setTimeTo( SUNDAY, 2 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 3, LIGHT_ON );
+    checkLightState( 4, LIGHT_ON );
+}
+
+TEST( LightScheduler, CatchUpIsLimitedToItsWindow )
+{
+    LightScheduler_SetCatchUpWindow( scheduler, 5 );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOn( scheduler, 4, MONDAY, 606 );
+
+    /* 10:00 am is more than 5 minutes before 10:10 am, 10:06 am is not */
+    setTimeTo( MONDAY, 590 );
+    LightScheduler_WakeUp( scheduler );
+    setTimeTo( MONDAY, 610 );
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( 3, LIGHT_STATE_UNKNOWN );
+    checkLightState( 4, LIGHT_ON );
+}
+
+TEST( LightScheduler, SecondWakeUpInTheSameMinuteDoesNothing )
+{
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( scheduler );
+
+    /* forget the light change, the event must not fire again */
+    LightController_Create();
+    LightScheduler_WakeUp( scheduler );
+
+    checkLightState( LIGHT_ID_UNKNOWN, LIGHT_STATE_UNKNOWN );
+}
+
+TEST( LightScheduler, NothingIsDueWithoutEvents )
+{
+    setTimeTo( MONDAY, 600 );
+
+    LONGS_EQUAL( LS_NOTHING_DUE, LightScheduler_NextDue( scheduler ) );
+}
+
+TEST( LightScheduler, NextDueIsTheMinuteOfWeekOfTheNextEvent )
+{
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+    LightScheduler_ScheduleTurnOff( scheduler, 4, SUNDAY, 30 );
+
+    /* monday 10:00 am is minute 1440 + 600 of the week */
+    setTimeTo( MONDAY, 100 );
+    LONGS_EQUAL( 1440 + 600, LightScheduler_NextDue( scheduler ) );
+
+    /* past monday, the week wraps around to sunday 00:30 am */
+    setTimeTo( TUESDAY, 0 );
+    LONGS_EQUAL( 30, LightScheduler_NextDue( scheduler ) );
+}
+
+TEST( LightScheduler, NextDueSkipsTheMinuteAlreadyProcessed )
+{
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+
+    /* the event is due now, until the wake-up processes it ... */
+    setTimeTo( MONDAY, 600 );
+    LONGS_EQUAL( 1440 + 600, LightScheduler_NextDue( scheduler ) );
+
+    /* ... then it is due again next week */
+    LightScheduler_WakeUp( scheduler );
+    LONGS_EQUAL( 1440 + 600, LightScheduler_NextDue( scheduler ) );
+    checkLightState( 3, LIGHT_ON );
+}
+
+TEST( LightScheduler, TicklessArmsAOneShotAlarmForTheNextEvent )
+{
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+
+    /* the periodic alarm is gone, the one-shot alarm fires in 10 minutes */
+    setTimeTo( MONDAY, 590 );
+    LightScheduler_SetTickless( scheduler, TRUE );
+    LONGS_EQUAL( 0, FakeTimeSource_GetAlarmPeriodInSeconds() );
+    LONGS_EQUAL( 10 * 60, FakeTimeService_GetOneShotAlarmInSeconds() );
+    POINTERS_EQUAL( scheduler, FakeTimeService_GetAlarmContext() );
+
+    /* firing it turns the light on and arms the alarm for the same event next week */
+    setTimeTo( MONDAY, 600 );
+    FakeTimeService_GetAlarmCallback()( FakeTimeService_GetAlarmContext() );
+    checkLightState( 3, LIGHT_ON );
+    LONGS_EQUAL( 7 * 1440 * 60, FakeTimeService_GetOneShotAlarmInSeconds() );
+
+    /* an earlier event moves the alarm closer */
+    LightScheduler_ScheduleTurnOff( scheduler, 3, MONDAY, 700 );
+    LONGS_EQUAL( 100 * 60, FakeTimeService_GetOneShotAlarmInSeconds() );
+}
+
+TEST( LightScheduler, TicklessWithoutEventsArmsNoAlarm )
+{
+    setTimeTo( MONDAY, 590 );
+    LightScheduler_SetTickless( scheduler, TRUE );
+    LONGS_EQUAL( TIME_UNKNOWN, FakeTimeService_GetOneShotAlarmInSeconds() );
+
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEDNESDAY, 0 );
+    LONGS_EQUAL( ( 2 * 1440 - 590 ) * 60, FakeTimeService_GetOneShotAlarmInSeconds() );
+
+    /* removing the only event cancels the alarm */
+    LightScheduler_ScheduleRemove( scheduler, 3, WEDNESDAY, 0 );
+    LONGS_EQUAL( TIME_UNKNOWN, FakeTimeService_GetOneShotAlarmInSeconds() );
+}
+
+TEST( LightScheduler, LeavingTicklessRestoresTheOneMinuteAlarm )
+{
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+    setTimeTo( MONDAY, 590 );
+
+    LightScheduler_SetTickless( scheduler, TRUE );
+    LightScheduler_SetTickless( scheduler, FALSE );
+
+    LONGS_EQUAL( TIME_UNKNOWN, FakeTimeService_GetOneShotAlarmInSeconds() );
+    LONGS_EQUAL( 60, FakeTimeSource_GetAlarmPeriodInSeconds() );
+    POINTERS_EQUAL( scheduler, FakeTimeService_GetAlarmContext() );
+}
+
 TEST( LightScheduler, AcceptsValidLightIds )
 {
     /* This test schedules only valid light IDs to turn on.
@@ -500,13 +825,13 @@ TEST( LightScheduler, AcceptsValidLightIds )
        the expected result is OK */
 
     /* schedule light ID 0 to turn on */
-    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( 0, MONDAY, 600 ) );
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 0, MONDAY, 600 ) );
 
     /* schedule light ID 15 to turn on */
-    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( 15, MONDAY, 600 ) );
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 15, MONDAY, 600 ) );
 
     /* schedule light ID 31 to turn on */
-    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( 31, MONDAY, 600 ) );
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 31, MONDAY, 600 ) );
 }
 
 TEST( LightScheduler, RejectsInvalidLightIds )
@@ -515,8 +840,144 @@ TEST( LightScheduler, RejectsInvalidLightIds )
        Even though there are enough scheduled event slots, the expected result is id out of bounds */
 
     /* schedule light ID -1 to turn on */
-    LONGS_EQUAL( LS_ID_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOn( -1, MONDAY, 600 ) );
+    LONGS_EQUAL( LS_ID_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOn( scheduler, -1, MONDAY, 600 ) );
 
     /* schedule light ID 32 to turn on */
-    LONGS_EQUAL( LS_ID_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOn( 32, MONDAY, 600 ) );   
+    LONGS_EQUAL( LS_ID_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOn( scheduler, 32, MONDAY, 600 ) );   
+}
+
+TEST( LightScheduler, RejectsTimesOutsideOfTheWeek )
+{
+    /* a minute outside of the day or a day outside of the Day values could never fire */
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, -1 ) );
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 1440 ) );
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOff( scheduler, 3, ( Day ) ( SATURDAY + 1 ), 600 ) );
+
+    /* the first and last minutes of the day are fine */
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 3, SATURDAY, 0 ) );
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 3, EVERYDAY, 1439 ) );
+}
+
+TEST( LightScheduler, DaySetFiresOnEveryDayOfTheSet )
+{
+    /* monday, wednesday and friday in a single event */
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOnDays( scheduler, 3, ( Days ) ( DAYS_MONDAY | DAYS_WEDNESDAY | DAYS_FRIDAY ), 1200 ) );
+
+    setTimeTo( TUESDAY, 1200 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( LIGHT_ID_UNKNOWN, LIGHT_STATE_UNKNOWN );
+
+    setTimeTo( WEDNESDAY, 1200 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 3, LIGHT_ON );
+
+    LightController_Create();
+    setTimeTo( FRIDAY, 1200 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 3, LIGHT_ON );
+}
+
+TEST( LightScheduler, DaysAreTheSameSetsAsTheirDayValues )
+{
+    /* an event scheduled for WEEKEND is removed as DAYS_WEEKEND and the other way around */
+    LightScheduler_ScheduleTurnOn( scheduler, 3, WEEKEND, 600 );
+    LightScheduler_ScheduleTurnOnDays( scheduler, 4, DAYS_TUESDAY, 600 );
+
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemoveDays( scheduler, 3, ( Days ) ( DAYS_SATURDAY | DAYS_SUNDAY ), 600 ) );
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, 4, TUESDAY, 600 ) );
+    LONGS_EQUAL( LS_EVENT_DOES_NOT_EXIST, LightScheduler_ScheduleRemove( scheduler, 4, EVERYDAY, 600 ) );
+}
+
+TEST( LightScheduler, RejectsDaySetsOutsideOfTheWeek )
+{
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOnDays( scheduler, 3, ( Days ) ( DAYS_EVERYDAY + 1 ), 600 ) );
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOffDays( scheduler, 3, ( Days ) -1, 600 ) );
+}
+
+TEST( LightScheduler, RejectsEmptyDaySets )
+{
+    /* an event without a single day could never fire */
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOnDays( scheduler, 3, DAYS_NONE, 600 ) );
+    LONGS_EQUAL( LS_TIME_OUT_OF_BOUNDS, LightScheduler_ScheduleTurnOff( scheduler, 3, NOT_A_DAY, 600 ) );
+    LONGS_EQUAL( LS_NOTHING_DUE, LightScheduler_NextDue( scheduler ) );
+}
+
+TEST( LightScheduler, BatchesNest )
+{
+    setTimeTo( MONDAY, 590 );
+    LightScheduler_SetTickless( scheduler, TRUE );
+
+    LightScheduler_BeginBatch( scheduler );
+    LightScheduler_BeginBatch( scheduler );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+
+    /* the inner end does not end the outer batch, the alarm is armed by the outermost end only */
+    LightScheduler_EndBatch( scheduler );
+    LONGS_EQUAL( TIME_UNKNOWN, FakeTimeService_GetOneShotAlarmInSeconds() );
+
+    LightScheduler_EndBatch( scheduler );
+    LONGS_EQUAL( 10 * 60, FakeTimeService_GetOneShotAlarmInSeconds() );
+}
+
+TEST( LightScheduler, RemoveDuringABatchKeepsTheBatch )
+{
+    int i;
+
+    setTimeTo( MONDAY, 0 );
+    LightScheduler_SetTickless( scheduler, TRUE );
+    LightScheduler_BeginBatch( scheduler );
+
+    /* enough events to grow the storage (and its hash table) in the middle of the batch */
+    for ( i = 0; i < 300; i++ )
+    {
+        LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, i % 32, MONDAY, 100 + i ) );
+    }
+
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, 0, MONDAY, 100 ) );
+    LONGS_EQUAL( LS_EVENT_DOES_NOT_EXIST, LightScheduler_ScheduleRemove( scheduler, 0, MONDAY, 100 ) );
+
+    /* the events scheduled after the removal can be found too */
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleTurnOn( scheduler, 0, MONDAY, 50 ) );
+    LONGS_EQUAL( LS_OK, LightScheduler_ScheduleRemove( scheduler, 0, MONDAY, 50 ) );
+
+    /* the batch is still on */
+    LONGS_EQUAL( TIME_UNKNOWN, FakeTimeService_GetOneShotAlarmInSeconds() );
+
+    LightScheduler_EndBatch( scheduler );
+    LONGS_EQUAL( 101 * 60, FakeTimeService_GetOneShotAlarmInSeconds() );
+}
+
+TEST( LightScheduler, CompiledWakeUpDuringABatch )
+{
+    LightScheduler_SetCompiled( scheduler, TRUE );
+    LightScheduler_BeginBatch( scheduler );
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 600 );
+
+    /* the masks are compiled for the wake-up, the batch goes on */
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 3, LIGHT_ON );
+
+    LightScheduler_ScheduleTurnOff( scheduler, 3, MONDAY, 601 );
+    LightScheduler_EndBatch( scheduler );
+
+    setTimeTo( MONDAY, 601 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 3, LIGHT_OFF );
+}
+
+TEST( LightScheduler, CompiledWithoutEventsDoesNothing )
+{
+    /* no event has been scheduled yet, so the timing wheel has no bucket heads at all */
+    LightScheduler_SetCompiled( scheduler, TRUE );
+
+    setTimeTo( MONDAY, 600 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( LIGHT_ID_UNKNOWN, LIGHT_STATE_UNKNOWN );
+
+    /* the first event brings them */
+    LightScheduler_ScheduleTurnOn( scheduler, 3, MONDAY, 601 );
+    setTimeTo( MONDAY, 601 );
+    LightScheduler_WakeUp( scheduler );
+    checkLightState( 3, LIGHT_ON );
 }
@@ -0,0 +1,190 @@
+/**
+ * @file    AsyncCircularBufferTest.cpp
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Async (C++20 coroutine) Circular Buffer test file
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+/* includes for things with C++ linkage */
+#include "AsyncCircularBuffer.h"
+#include "TestHarness.h"
+
+/* Minimal fire-and-forget coroutine type used by the tests.
+   The coroutine starts running right away and its frame is released as soon as it finishes */
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() {}
+    };
+};
+
+/* consumer coroutine: waits for 'count' values and stores them in 'received' */
+static DetachedTask consume( AsyncCircularBuffer &buffer, int *received, int count )
+{
+    for ( int i = 0; i < count; i++ )
+    {
+        received[ i ] = co_await buffer.get();
+    }
+}
+
+/* producer coroutine: puts the values 'first' to 'first + count - 1' and counts how many went in */
+static DetachedTask produce( AsyncCircularBuffer &buffer, int first, int count, int *produced )
+{
+    for ( int i = 0; i < count; i++ )
+    {
+        co_await buffer.put( first + i );
+        ( *produced )++;
+    }
+}
+
+/* ping-pong coroutine: puts 'count' values into 'out' and waits for an answer from 'in' after each one */
+static DetachedTask pingPong( AsyncCircularBuffer &out, AsyncCircularBuffer &in, int count, int *exchanged )
+{
+    for ( int i = 0; i < count; i++ )
+    {
+        co_await out.put( i );
+        co_await in.get();
+        ( *exchanged )++;
+    }
+}
+
+TEST_GROUP( AsyncCircularBuffer )
+{
+    /* define data accessible to test group members here */
+
+    AsyncCircularBuffer *buffer; /* coroutine aware circular buffer */
+
+    void setup()
+    {
+        /* initialization steps are executed before each TEST */
+        buffer = new AsyncCircularBuffer( 3 );
+    }
+
+    void teardown()
+    {
+        /* clean up steps are executed after each TEST */
+        delete buffer;
+    }
+};
+
+TEST( AsyncCircularBuffer, GetDoesNotSuspendWhenValueIsAvailable )
+{
+    int received[ 1 ] = { -1 };
+
+    /* a value of 0 is a valid value, it must not be mistaken for an empty circular buffer */
+    CircularBuffer_Put( buffer->circularBuffer(), 0 );
+
+    consume( *buffer, received, 1 );
+
+    LONGS_EQUAL( 0, received[ 0 ] );
+    CHECK_TRUE( CircularBuffer_IsEmpty( buffer->circularBuffer() ) );
+}
+
+TEST( AsyncCircularBuffer, GetSuspendsUntilPut )
+{
+    int received[ 1 ] = { -1 };
+    int produced = 0;
+
+    /* the circular buffer is empty, so the consumer suspends */
+    consume( *buffer, received, 1 );
+    LONGS_EQUAL( -1, received[ 0 ] );
+
+    /* putting a value resumes the consumer */
+    produce( *buffer, 17, 1, &produced );
+
+    LONGS_EQUAL( 17, received[ 0 ] );
+    LONGS_EQUAL( 1, produced );
+
+    /* the value was handed over, it never went through the circular buffer */
+    CHECK_TRUE( CircularBuffer_IsEmpty( buffer->circularBuffer() ) );
+}
+
+TEST( AsyncCircularBuffer, PutSuspendsWhenFullUntilGet )
+{
+    int received[ 5 ];
+    int produced = 0;
+
+    /* the capacity is 3, so the producer suspends on the fourth value */
+    produce( *buffer, 10, 5, &produced );
+    LONGS_EQUAL( 3, produced );
+    CHECK_TRUE( CircularBuffer_IsFull( buffer->circularBuffer() ) );
+
+    /* every get() frees a slot and lets the producer carry on */
+    consume( *buffer, received, 5 );
+
+    LONGS_EQUAL( 5, produced );
+    LONGS_EQUAL( 10, received[ 0 ] );
+    LONGS_EQUAL( 11, received[ 1 ] );
+    LONGS_EQUAL( 12, received[ 2 ] );
+    LONGS_EQUAL( 13, received[ 3 ] );
+    LONGS_EQUAL( 14, received[ 4 ] );
+}
+
+TEST( AsyncCircularBuffer, WaitingConsumersAreResumedInOrder )
+{
+    enum { CONSUMERS = 1000 };
+
+    static int received[ CONSUMERS ];
+    int produced = 0;
+    int i;
+
+    /* a thousand consumers wait on the same buffer, no thread is needed for any of them */
+    for ( i = 0; i < CONSUMERS; i++ )
+    {
+        received[ i ] = -1;
+        consume( *buffer, &received[ i ], 1 );
+    }
+
+    produce( *buffer, 0, CONSUMERS, &produced );
+
+    /* the oldest waiting consumer gets the oldest value */
+    for ( i = 0; i < CONSUMERS; i++ )
+    {
+        LONGS_EQUAL( i, received[ i ] );
+    }
+
+    LONGS_EQUAL( CONSUMERS, produced );
+}
+
+TEST( AsyncCircularBuffer, LongPingPongDoesNotNestStackFrames )
+{
+    enum { EXCHANGES = 200000 };
+
+    AsyncCircularBuffer answers( 1 );
+    int pings = 0;
+    int pongs = 0;
+
+    /* every hand-off wakes up the other coroutine, resuming it inline would nest a stack frame per exchange */
+    pingPong( answers, *buffer, EXCHANGES, &pongs );
+    pingPong( *buffer, answers, EXCHANGES, &pings );
+
+    LONGS_EQUAL( EXCHANGES, pings );
+    LONGS_EQUAL( EXCHANGES, pongs );
+}
+
+TEST( AsyncCircularBuffer, ZeroCapacityHandsValuesOver )
+{
+    AsyncCircularBuffer rendezvous( 0 );
+    int received[ 3 ];
+    int produced = 0;
+
+    /* nothing can be stored, so the producer suspends on its first value ... */
+    produce( rendezvous, 7, 3, &produced );
+    LONGS_EQUAL( 0, produced );
+
+    /* ... and every get() takes a value straight from it */
+    consume( rendezvous, received, 3 );
+
+    LONGS_EQUAL( 3, produced );
+    LONGS_EQUAL( 7, received[ 0 ] );
+    LONGS_EQUAL( 8, received[ 1 ] );
+    LONGS_EQUAL( 9, received[ 2 ] );
+    CHECK_TRUE( CircularBuffer_IsEmpty( rendezvous.circularBuffer() ) );
+}
@@ -0,0 +1,125 @@
+/**
+ * @file    CircularBufferPoolTest.cpp
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Circular Buffer Pool test file
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+extern "C"
+{
+    /* includes for things with C linkage */
+    #include "CircularBufferPool.h"
+}
+
+/* includes for things with C++ linkage */
+#include "TestHarness.h"
+
+TEST_GROUP( CircularBufferPool )
+{
+    /* define data accessible to test group members here */
+
+    CircularBufferPool pool; /* pool of circular buffers */
+
+    void setup()
+    {
+        /* initialization steps are executed before each TEST */
+
+        /* three capacity classes (given unsorted on purpose), two circular buffers per slab */
+        const int capacities[] = { 64, 8, 16 };
+
+        pool = CircularBufferPool_Create( capacities, 3, 2 );
+    }
+
+    void teardown()
+    {
+        /* clean up steps are executed after each TEST */
+        CircularBufferPool_Destroy( pool );
+    }
+};
+
+TEST( CircularBufferPool, AcquiredBufferBehavesLikeACircularBuffer )
+{
+    CircularBuffer buffer = CircularBufferPool_Acquire( pool, 3 );
+
+    CHECK_TRUE( CircularBuffer_IsEmpty( buffer ) );
+
+    /* a capacity of 3 is served by the 8 values class, but the circular buffer keeps the requested capacity */
+    CHECK_TRUE( CircularBuffer_Put( buffer, 1 ) );
+    CHECK_TRUE( CircularBuffer_Put( buffer, 2 ) );
+    CHECK_TRUE( CircularBuffer_Put( buffer, 3 ) );
+    CHECK_FALSE( CircularBuffer_Put( buffer, 4 ) );
+
+    LONGS_EQUAL( 1, CircularBuffer_Get( buffer ) );
+    LONGS_EQUAL( 2, CircularBuffer_Get( buffer ) );
+    LONGS_EQUAL( 3, CircularBuffer_Get( buffer ) );
+    CHECK_TRUE( CircularBuffer_IsEmpty( buffer ) );
+
+    CircularBufferPool_Release( pool, buffer );
+}
+
+TEST( CircularBufferPool, ReleasedBufferIsRecycledEmpty )
+{
+    CircularBuffer first = CircularBufferPool_Acquire( pool, 8 );
+    CircularBuffer second;
+
+    CircularBuffer_Put( first, 42 );
+    CircularBufferPool_Release( pool, first );
+
+    /* the slot just released is the first one to be handed out again, and it comes back empty */
+    second = CircularBufferPool_Acquire( pool, 5 );
+
+    POINTERS_EQUAL( first, second );
+    CHECK_TRUE( CircularBuffer_IsEmpty( second ) );
+
+    CircularBufferPool_Release( pool, second );
+}
+
+TEST( CircularBufferPool, BuffersFromDifferentClassesAreDistinct )
+{
+    CircularBuffer small = CircularBufferPool_Acquire( pool, 8 );
+    CircularBuffer large = CircularBufferPool_Acquire( pool, 64 );
+
+    CHECK( small != large );
+
+    /* filling up the large circular buffer must not touch the small one */
+    for ( int i = 0; i < 64; i++ )
+    {
+        CHECK_TRUE( CircularBuffer_Put( large, i ) );
+    }
+
+    CHECK_TRUE( CircularBuffer_IsEmpty( small ) );
+    CHECK_TRUE( CircularBuffer_IsFull( large ) );
+
+    CircularBufferPool_Release( pool, small );
+    CircularBufferPool_Release( pool, large );
+}
+
+TEST( CircularBufferPool, GrowsWhenASlabRunsOut )
+{
+    enum { BUFFERS = 5 };
+
+    CircularBuffer buffers[ BUFFERS ];
+    int i;
+
+    /* only two circular buffers fit in a slab, so extra slabs have to be allocated */
+    for ( i = 0; i < BUFFERS; i++ )
+    {
+        buffers[ i ] = CircularBufferPool_Acquire( pool, 16 );
+        CHECK( buffers[ i ] != NULL );
+        CHECK_TRUE( CircularBuffer_Put( buffers[ i ], i ) );
+    }
+
+    /* every circular buffer kept its own value */
+    for ( i = 0; i < BUFFERS; i++ )
+    {
+        LONGS_EQUAL( i, CircularBuffer_Get( buffers[ i ] ) );
+        CircularBufferPool_Release( pool, buffers[ i ] );
+    }
+}
+
+TEST( CircularBufferPool, RejectsCapacityLargerThanAnyClass )
+{
+    POINTERS_EQUAL( NULL, CircularBufferPool_Acquire( pool, 65 ) );
+}
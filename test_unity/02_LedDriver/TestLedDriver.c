@@ -21,6 +21,12 @@
  *              x - Runtime error
  *                - What should really happen?
  *          x - Hardware interaction
+ *          x - Multiple boards, one driver each
+ *          x - Masked (batch) operations with a single register write
+ *          x - Redundant writes are skipped
+ *          x - Deferred updates (begin update / flush)
+ *          x - Instrumentation hook
+ *          x - A frame is a single hardware update
  * 
  * @version 0.1
  * @date    2025-02-21
@@ -33,6 +39,18 @@
 /* address of the 16 LEDs */
 static uint16_t virtualLeds;
 
+/* driver of the board whose LEDs are at virtualLeds */
+static LedDriver leds;
+
+/* hardware updates seen by the instrumentation hook */
+static int hardwareUpdates;
+
+static void countHardwareUpdate( void *context, LedDriver self )
+{
+   ( void ) self;
+   ( *( int * ) context )++;
+}
+
 TEST_GROUP( LedDriver );
 
 TEST_SETUP( LedDriver )
@@ -42,11 +60,13 @@ TEST_SETUP( LedDriver )
       LedDriver_Create() will assign the address of virtualLeds (used here in the tests)
       as the address of ledsAddress (which is used in the LedDriver) and will initialize
       all of the LEDs to 0 (off) */
-   LedDriver_Create( &virtualLeds );
+   leds = LedDriver_Create( &virtualLeds );
 }
 
 TEST_TEAR_DOWN( LedDriver )
 {
+   /* release the driver created in TEST_SETUP() */
+   LedDriver_Destroy( leds );
 }
 
 /* TEST 1 */
@@ -66,17 +86,19 @@ TEST( LedDriver, LedsOffAfterCreate )
 
    /* per the spec, the LedDriver_Create() is responsible for 
       turning all LEDs off during initialization */
-   LedDriver_Create( &virtualLeds );
+   LedDriver driver = LedDriver_Create( &virtualLeds );
 
    /* check that in fact all LEDs are off upon initialization */
    TEST_ASSERT_EQUAL_HEX16( 0, virtualLeds );
+
+   LedDriver_Destroy( driver );
 }
 
 /* TEST 2 */
 TEST( LedDriver, TurnOnLedOne )
 {
    /* turn the first LED (LED 1) on */
-   LedDriver_TurnOn( 1 );
+   LedDriver_TurnOn( leds, 1 );
 
    /* check LED 1 is on */
    TEST_ASSERT_EQUAL_HEX16( 1, virtualLeds );
@@ -86,11 +108,11 @@ TEST( LedDriver, TurnOnLedOne )
 TEST( LedDriver, TurnOffLedOne )
 {
    /* turn the first LED (LED 1) on */
-   LedDriver_TurnOn( 1 );
+   LedDriver_TurnOn( leds, 1 );
 
    /* turn the first LED off.
       The LEDs are numbered 01 through 16, so bit 0 is LED 01 */
-   LedDriver_TurnOff( 1 );
+   LedDriver_TurnOff( leds, 1 );
 
    /* check LED 1 is off */
    TEST_ASSERT_EQUAL_HEX16( 0, virtualLeds );
@@ -100,10 +122,10 @@ TEST( LedDriver, TurnOffLedOne )
 TEST( LedDriver, TurnOffAnyLed )
 {
    /* turn on all LEDs */
-   LedDriver_TurnAllOn();
+   LedDriver_TurnAllOn( leds );
 
    /* turn off LED 8 */
-   LedDriver_TurnOff( 8 );
+   LedDriver_TurnOff( leds, 8 );
 
    /* check that only LED 8 is off */
    TEST_ASSERT_EQUAL_HEX16( 0xff7f, virtualLeds );
@@ -113,8 +135,8 @@ TEST( LedDriver, TurnOffAnyLed )
 TEST( LedDriver, TurnOnMultipleLeds )
 {
    /* turn on both LEDs 9 and 8 */
-   LedDriver_TurnOn( 8 );
-   LedDriver_TurnOn( 9 );
+   LedDriver_TurnOn( leds, 8 );
+   LedDriver_TurnOn( leds, 9 );
 
    /* check both LEDs 9 and 8 are on.
       The LEDs are numbered 1 through 16, so bit 8 is LED 9
@@ -129,11 +151,11 @@ TEST( LedDriver, TurnOffMultipleLeds )
       the calling to LedDriver_Create() before each test's execution */
 
    /* turn on all the 16 LEDs */
-   LedDriver_TurnAllOn();
+   LedDriver_TurnAllOn( leds );
    
    /* turn off both LEDs 8 and 9 */
-   LedDriver_TurnOff( 8 );
-   LedDriver_TurnOff( 9 );
+   LedDriver_TurnOff( leds, 8 );
+   LedDriver_TurnOff( leds, 9 );
 
    /* check only LEDs 9 and 8 are off () */
    TEST_ASSERT_EQUAL_HEX16( ~0x180 & 0xFFFF, virtualLeds );
@@ -143,7 +165,7 @@ TEST( LedDriver, TurnOffMultipleLeds )
 TEST( LedDriver, AllOn )
 {
    /* turn on all the 16 LEDs */
-   LedDriver_TurnAllOn();
+   LedDriver_TurnAllOn( leds );
 
    /* check all LEDs are on */
    TEST_ASSERT_EQUAL_HEX( 0xffff, virtualLeds );
@@ -156,10 +178,10 @@ TEST( LedDriver, AllOff )
       the calling to LedDriver_Create() before each test's execution */
 
    /* turn on all the 16 LEDs */
-   LedDriver_TurnAllOn();
+   LedDriver_TurnAllOn( leds );
 
    /* turn on all the 16 LEDs */
-   LedDriver_TurnAllOff();
+   LedDriver_TurnAllOff( leds );
 
    /* check all LEDs are off */
    TEST_ASSERT_EQUAL_HEX16( 0, virtualLeds );
@@ -172,13 +194,13 @@ TEST( LedDriver, IsOn )
       the calling to LedDriver_Create() before each test's execution */
 
    /* check LED 11 is not on */
-   TEST_ASSERT_FALSE( LedDriver_IsOn( 11 ) );
+   TEST_ASSERT_FALSE( LedDriver_IsOn( leds, 11 ) );
 
    /* turn on LED 11 */
-   LedDriver_TurnOn( 11 );
+   LedDriver_TurnOn( leds, 11 );
 
    /* check LED 11 is on */
-   TEST_ASSERT_TRUE( LedDriver_IsOn( 11 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOn( leds, 11 ) );
 }
 
 /* TEST 10 */ 
@@ -188,13 +210,13 @@ TEST( LedDriver, IsOff )
       the calling to LedDriver_Create() before each test's execution */
       
    /* check LED 12 is off */
-   TEST_ASSERT_TRUE( LedDriver_IsOff( 12 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOff( leds, 12 ) );
 
    /* turn on LED 12 */
-   LedDriver_TurnOn( 12 );
+   LedDriver_TurnOn( leds, 12 );
 
    /* check LED 12 is not off */
-   TEST_ASSERT_FALSE( LedDriver_IsOff( 12 ) );
+   TEST_ASSERT_FALSE( LedDriver_IsOff( leds, 12 ) );
 }
 
 /* TEST 11 */ 
@@ -208,7 +230,7 @@ TEST( LedDriver, LedMemoryIsNotReadable )
    virtualLeds = 0xffff;
 
    /* turn on LED 8 */
-   LedDriver_TurnOn( 8 );
+   LedDriver_TurnOn( leds, 8 );
 
    /* at this point, if the driver can read the state of the LEDs,
       then virtualLeds would be 0x80 (7 bit high, which corresponds
@@ -222,8 +244,8 @@ TEST( LedDriver, UpperAndLowerBounds )
    /* this test checks the upper and lower bounds of the legal LED values */
 
    /* turn on both LEDs 1 and 16 */
-   LedDriver_TurnOn( 1 );
-   LedDriver_TurnOn( 16 );
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnOn( leds, 16 );
 
    /* check that both LEDs 1 and 16 are on */
    TEST_ASSERT_EQUAL_HEX16( 0x8001, virtualLeds );
@@ -234,10 +256,10 @@ TEST( LedDriver, OutOfBoundsTurnOnDoesNoHarm )
 {
    /* this test exercises the LedDriver with some fence-post values
       and a way out-of-bounds value */
-   LedDriver_TurnOn( -1 );
-   LedDriver_TurnOn( 0 );
-   LedDriver_TurnOn( 17 );
-   LedDriver_TurnOn( 3141 );
+   LedDriver_TurnOn( leds, -1 );
+   LedDriver_TurnOn( leds, 0 );
+   LedDriver_TurnOn( leds, 17 );
+   LedDriver_TurnOn( leds, 3141 );
 
    /* if everything was well done, then nothing should have happened
       when writing out of the legal LED values. All 16 LEDs should be off */
@@ -251,13 +273,13 @@ TEST( LedDriver, OutOfBoundsTurnOffDoesNoHarm )
       and a way out-of-bounds value */
 
    /* turn on all the LEDs */
-   LedDriver_TurnAllOn();
+   LedDriver_TurnAllOn( leds );
 
    /* attempt to turn off out-of-bounds LEDs */
-   LedDriver_TurnOff( -1 );
-   LedDriver_TurnOff( 0 );
-   LedDriver_TurnOff( 17 );
-   LedDriver_TurnOff( 3141 );
+   LedDriver_TurnOff( leds, -1 );
+   LedDriver_TurnOff( leds, 0 );
+   LedDriver_TurnOff( leds, 17 );
+   LedDriver_TurnOff( leds, 3141 );
 
    /* if everything was well done, then nothing should have happened
       when writing out of the legal LED values, All 16 LEDs should be on */
@@ -271,7 +293,7 @@ TEST( LedDriver, OutOfBoundsProducesRuntimeError )
    int errorParameter;
 
    /* attempt to turn off an out-of-bounds LED */
-   LedDriver_TurnOn( -2 );
+   LedDriver_TurnOn( leds, -2 );
 
    /* get the last runtime error message and error parameter */
    errorMessage   = RuntimeErrorStub_GetLastError();
@@ -293,23 +315,227 @@ TEST( LedDriver, OutOfBoundsLedsAreAlwaysOff )
       the calling to LedDriver_Create() before each test's execution */
 
    /* turn on all the 16 LEDs */
-   LedDriver_TurnAllOn();
+   LedDriver_TurnAllOn( leds );
    
    /* check both (out-of-bounds) LEDs 0 and 17 are not on */
-   TEST_ASSERT_FALSE( LedDriver_IsOn( 0 ) );
-   TEST_ASSERT_FALSE( LedDriver_IsOn( 17 ) );
+   TEST_ASSERT_FALSE( LedDriver_IsOn( leds, 0 ) );
+   TEST_ASSERT_FALSE( LedDriver_IsOn( leds, 17 ) );
 
    /* check both (out-of-bounds) LEDs 0 and 17 are off */
-   TEST_ASSERT_TRUE( LedDriver_IsOff( 0 ) );
-   TEST_ASSERT_TRUE( LedDriver_IsOff( 17 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOff( leds, 0 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOff( leds, 17 ) );
 }
 
 /* TEST 17 */
+TEST( LedDriver, MultipleBoardsAreIndependent )
+{
+   /* the LEDs of a second board */
+   uint16_t otherVirtualLeds = 0xffff;
+
+   /* each board gets its own driver */
+   LedDriver other = LedDriver_Create( &otherVirtualLeds );
+
+   /* operate both boards */
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnOn( other, 16 );
+   LedDriver_TurnAllOn( leds );
+   LedDriver_TurnOff( leds, 2 );
+
+   /* check every board only reflects its own operations */
+   TEST_ASSERT_EQUAL_HEX16( 0xfffd, virtualLeds );
+   TEST_ASSERT_EQUAL_HEX16( 0x8000, otherVirtualLeds );
+   TEST_ASSERT_TRUE( LedDriver_IsOff( leds, 2 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOn( other, 16 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOff( other, 2 ) );
+
+   LedDriver_Destroy( other );
+}
+
+/* TEST 18 */
+TEST( LedDriver, SetMaskTurnsOnLedsWithOneWrite )
+{
+   /* LEDs 1, 2, 3, 5, 8, 9, 10, 12, 15 and 16 */
+   LedWord onMask = 0xcb97;
+   uint32_t writes = LedDriver_GetRegisterWriteCount( leds );
+   int i;
+
+   /* the same 10 LEDs one at a time cost 10 register writes ... */
+   for ( i = 1; i <= 16; i++ )
+   {
+      if ( onMask & ( 1 << ( i - 1 ) ) )
+      {
+         LedDriver_TurnOn( leds, i );
+      }
+   }
+
+   TEST_ASSERT_EQUAL( 10, LedDriver_GetRegisterWriteCount( leds ) - writes );
+
+   /* ... while the mask costs a single one */
+   LedDriver_TurnAllOff( leds );
+   writes = LedDriver_GetRegisterWriteCount( leds );
+   LedDriver_SetMask( leds, &onMask );
+
+   TEST_ASSERT_EQUAL( 1, LedDriver_GetRegisterWriteCount( leds ) - writes );
+   TEST_ASSERT_EQUAL_HEX16( 0xcb97, virtualLeds );
+}
+
+/* TEST 19 */
+TEST( LedDriver, ClearMaskTurnsOffLeds )
+{
+   LedWord offMask = 0x00f0;
+
+   LedDriver_TurnAllOn( leds );
+   LedDriver_ClearMask( leds, &offMask );
+
+   TEST_ASSERT_EQUAL_HEX16( 0xff0f, virtualLeds );
+}
+
+/* TEST 20 */
+TEST( LedDriver, ApplyTurnsLedsOnAndOffWithOneWrite )
+{
+   LedWord onMask  = 0x000f;
+   LedWord offMask = 0x0ff0;
+   uint32_t writes;
+
+   /* start with LEDs 5 through 8 on */
+   virtualLeds = 0;
+   LedDriver_TurnOn( leds, 5 );
+   LedDriver_TurnOn( leds, 8 );
+   writes = LedDriver_GetRegisterWriteCount( leds );
+
+   /* LEDs 1 through 4 on, LEDs 5 through 12 off */
+   LedDriver_Apply( leds, &onMask, &offMask );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x000f, virtualLeds );
+   TEST_ASSERT_EQUAL( 1, LedDriver_GetRegisterWriteCount( leds ) - writes );
+}
+
+/* TEST 21 */
+TEST( LedDriver, MaskBitsBeyondLastLedAreIgnored )
+{
+   /* only the low 16 bits are LEDs on this board */
+   LedWord onMask = ~( LedWord ) 0;
+
+   LedDriver_SetMask( leds, &onMask );
+
+   TEST_ASSERT_TRUE( LedDriver_AreAllOn( leds ) );
+   TEST_ASSERT_EQUAL_HEX16( 0xffff, virtualLeds );
+}
+
+/* TEST 22 */
+TEST( LedDriver, RedundantWritesAreSkipped )
+{
+   uint32_t writes = LedDriver_GetRegisterWriteCount( leds );
+
+   /* only the first call changes the LEDs' state */
+   LedDriver_TurnOn( leds, 3 );
+   LedDriver_TurnOn( leds, 3 );
+
+   /* LED 5 is already off */
+   LedDriver_TurnOff( leds, 5 );
+
+   TEST_ASSERT_EQUAL( 1, LedDriver_GetRegisterWriteCount( leds ) - writes );
+   TEST_ASSERT_EQUAL_HEX16( 0x0004, virtualLeds );
+}
+
+/* TEST 23 */
+TEST( LedDriver, ChangesInsideAFrameCollapseIntoOneWrite )
+{
+   uint32_t writes = LedDriver_GetRegisterWriteCount( leds );
+
+   LedDriver_BeginUpdate( leds );
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnOn( leds, 2 );
+   LedDriver_TurnOn( leds, 3 );
+   LedDriver_TurnOff( leds, 2 );
+
+   /* nothing reaches the hardware until the flush, but the driver knows the pending state */
+   TEST_ASSERT_EQUAL_HEX16( 0, virtualLeds );
+   TEST_ASSERT_TRUE( LedDriver_IsOn( leds, 3 ) );
+
+   LedDriver_Flush( leds );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x0005, virtualLeds );
+   TEST_ASSERT_EQUAL( 1, LedDriver_GetRegisterWriteCount( leds ) - writes );
+}
+
+/* TEST 24 */
+TEST( LedDriver, FrameThatChangesNothingWritesNothing )
+{
+   uint32_t writes = LedDriver_GetRegisterWriteCount( leds );
+
+   LedDriver_BeginUpdate( leds );
+   LedDriver_TurnAllOn( leds );
+   LedDriver_TurnAllOff( leds );
+   LedDriver_Flush( leds );
+
+   TEST_ASSERT_EQUAL( 0, LedDriver_GetRegisterWriteCount( leds ) - writes );
+}
+
+/* TEST 25 */
+TEST( LedDriver, NestedFramesFlushOnce )
+{
+   LedDriver_BeginUpdate( leds );
+   LedDriver_TurnOn( leds, 16 );
+
+   LedDriver_BeginUpdate( leds );
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_Flush( leds );
+
+   /* the inner flush does not end the outer frame */
+   TEST_ASSERT_EQUAL_HEX16( 0, virtualLeds );
+
+   LedDriver_Flush( leds );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x8001, virtualLeds );
+}
+
+/* TEST 26 */
 IGNORE_TEST( LedDriver, OutOfBoundsToDo )
 {
    /* TODO: what should we do during runtime? */
 }
 
+/* TEST 27 */
+TEST( LedDriver, HookCountsHardwareUpdates )
+{
+   LedWord onMask = 0x00ff;
+
+   hardwareUpdates = 0;
+   LedDriver_SetUpdateHook( leds, countHardwareUpdate, &hardwareUpdates );
+
+   /* one update per operation, even when there is nothing to write */
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnAllOff( leds );
+   LedDriver_SetMask( leds, &onMask );
+
+   /* out-of-bounds LEDs never reach the hardware */
+   LedDriver_TurnOff( leds, 17 );
+
+   LedDriver_SetUpdateHook( leds, NULL, NULL );
+
+   TEST_ASSERT_EQUAL( 4, hardwareUpdates );
+}
+
+/* TEST 28 */
+TEST( LedDriver, HookCountsAFrameOnce )
+{
+   hardwareUpdates = 0;
+   LedDriver_SetUpdateHook( leds, countHardwareUpdate, &hardwareUpdates );
+
+   /* the deferred operations do not update the hardware, the flush does */
+   LedDriver_BeginUpdate( leds );
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnOn( leds, 2 );
+   LedDriver_TurnAllOn( leds );
+   LedDriver_Flush( leds );
+
+   LedDriver_SetUpdateHook( leds, NULL, NULL );
+
+   TEST_ASSERT_EQUAL( 1, hardwareUpdates );
+}
+
 TEST_GROUP_RUNNER( LedDriver )
 {
    /* TEST 1 */
@@ -361,5 +587,38 @@ TEST_GROUP_RUNNER( LedDriver )
    RUN_TEST_CASE( LedDriver, OutOfBoundsLedsAreAlwaysOff );
 
    /* TEST 17 */
+   RUN_TEST_CASE( LedDriver, MultipleBoardsAreIndependent );
+
+   /* TEST 18 */
+   RUN_TEST_CASE( LedDriver, SetMaskTurnsOnLedsWithOneWrite );
+
+   /* TEST 19 */
+   RUN_TEST_CASE( LedDriver, ClearMaskTurnsOffLeds );
+
+   /* TEST 20 */
+   RUN_TEST_CASE( LedDriver, ApplyTurnsLedsOnAndOffWithOneWrite );
+
+   /* TEST 21 */
+   RUN_TEST_CASE( LedDriver, MaskBitsBeyondLastLedAreIgnored );
+
+   /* TEST 22 */
+   RUN_TEST_CASE( LedDriver, RedundantWritesAreSkipped );
+
+   /* TEST 23 */
+   RUN_TEST_CASE( LedDriver, ChangesInsideAFrameCollapseIntoOneWrite );
+
+   /* TEST 24 */
+   RUN_TEST_CASE( LedDriver, FrameThatChangesNothingWritesNothing );
+
+   /* TEST 25 */
+   RUN_TEST_CASE( LedDriver, NestedFramesFlushOnce );
+
+   /* TEST 26 */
    RUN_TEST_CASE( LedDriver, OutOfBoundsToDo );
+
+   /* TEST 27 */
+   RUN_TEST_CASE( LedDriver, HookCountsHardwareUpdates );
+
+   /* TEST 28 */
+   RUN_TEST_CASE( LedDriver, HookCountsAFrameOnce );
 }
@@ -0,0 +1,313 @@
+/**
+ * @file    TestLedDriverBank.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Test source file containing the test cases and test group runner for the LedDriver module
+ *          when it drives wide LED banks (more than 16 LEDs behind several registers).
+ *
+ *          LED Driver Bank Tests:
+ *          ----------------------
+ *          x - All LEDs are off after the driver is initialized
+ *          x - LEDs map to the right register and bit
+ *          x - A single LED only touches its own register
+ *          x - Turn on/off all LEDs
+ *          x - Query the whole bank
+ *          x - Partial last register
+ *          x - 32 and 64-bit registers
+ *          x - Check out-of-bounds values
+ *          x - Unsupported register width
+ *          x - Masks spanning several image words
+ *          x - A flush only writes the registers that changed
+ *          x - Drivers set up one after the other in a single block
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "unity_fixture.h"
+#include "LedDriver.h"
+#include "RuntimeErrorStub.h"
+
+enum { BANK_LEDS = 256, BANK_REGISTERS = BANK_LEDS / 16 };
+
+/* sixteen 16-bit registers holding 256 LEDs */
+static uint16_t virtualRegisters[ BANK_REGISTERS ];
+
+/* driver of the bank */
+static LedDriver bank;
+
+TEST_GROUP( LedDriverBank );
+
+TEST_SETUP( LedDriverBank )
+{
+   int i; /* register index */
+
+   /* simulate the LEDs are all turned on during hardware initialization */
+   for ( i = 0; i < BANK_REGISTERS; i++ )
+   {
+      virtualRegisters[ i ] = 0xffff;
+   }
+
+   bank = LedDriver_CreateBank( virtualRegisters, BANK_LEDS, 16 );
+}
+
+TEST_TEAR_DOWN( LedDriverBank )
+{
+   LedDriver_Destroy( bank );
+}
+
+/* TEST 1 */
+TEST( LedDriverBank, LedsOffAfterCreate )
+{
+   int i; /* register index */
+
+   /* every register of the bank has been cleared */
+   for ( i = 0; i < BANK_REGISTERS; i++ )
+   {
+      TEST_ASSERT_EQUAL_HEX16( 0, virtualRegisters[ i ] );
+   }
+
+   TEST_ASSERT_TRUE( LedDriver_AreAllOff( bank ) );
+   TEST_ASSERT_EQUAL( BANK_LEDS, LedDriver_GetLedCount( bank ) );
+}
+
+/* TEST 2 */
+TEST( LedDriverBank, LedsMapToTheirRegister )
+{
+   /* LED 1 is bit 0 of register 0, LED 17 is bit 0 of register 1,
+      LED 65 is the first LED of the second image word, LED 256 is bit 15 of register 15 */
+   LedDriver_TurnOn( bank, 1 );
+   LedDriver_TurnOn( bank, 17 );
+   LedDriver_TurnOn( bank, 65 );
+   LedDriver_TurnOn( bank, 256 );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x0001, virtualRegisters[ 0 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0x0001, virtualRegisters[ 1 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0x0001, virtualRegisters[ 4 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0x8000, virtualRegisters[ 15 ] );
+
+   TEST_ASSERT_TRUE( LedDriver_IsOn( bank, 65 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOff( bank, 66 ) );
+}
+
+/* TEST 3 */
+TEST( LedDriverBank, SingleLedOnlyWritesItsRegister )
+{
+   /* mark a register the driver has no reason to touch */
+   virtualRegisters[ 3 ] = 0xbeef;
+
+   /* LED 40 lives in register 2 */
+   LedDriver_TurnOn( bank, 40 );
+   LedDriver_TurnOff( bank, 40 );
+   LedDriver_TurnOn( bank, 40 );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x0080, virtualRegisters[ 2 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0xbeef, virtualRegisters[ 3 ] );
+}
+
+/* TEST 4 */
+TEST( LedDriverBank, AllOnAndAllOff )
+{
+   int i; /* register index */
+
+   LedDriver_TurnAllOn( bank );
+
+   for ( i = 0; i < BANK_REGISTERS; i++ )
+   {
+      TEST_ASSERT_EQUAL_HEX16( 0xffff, virtualRegisters[ i ] );
+   }
+
+   TEST_ASSERT_TRUE( LedDriver_AreAllOn( bank ) );
+
+   LedDriver_TurnAllOff( bank );
+
+   for ( i = 0; i < BANK_REGISTERS; i++ )
+   {
+      TEST_ASSERT_EQUAL_HEX16( 0, virtualRegisters[ i ] );
+   }
+}
+
+/* TEST 5 */
+TEST( LedDriverBank, BankQueries )
+{
+   /* one LED on is enough for the bank not to be all off */
+   LedDriver_TurnOn( bank, 200 );
+   TEST_ASSERT_FALSE( LedDriver_AreAllOff( bank ) );
+   TEST_ASSERT_FALSE( LedDriver_AreAllOn( bank ) );
+
+   /* one LED off is enough for the bank not to be all on */
+   LedDriver_TurnAllOn( bank );
+   LedDriver_TurnOff( bank, 129 );
+   TEST_ASSERT_FALSE( LedDriver_AreAllOn( bank ) );
+   TEST_ASSERT_FALSE( LedDriver_AreAllOff( bank ) );
+}
+
+/* TEST 6 */
+TEST( LedDriverBank, PartialLastRegister )
+{
+   /* 100 LEDs need four 32-bit registers, only 4 bits of the last one are LEDs */
+   uint32_t registers[ 4 ];
+   LedDriver partial = LedDriver_CreateBank( registers, 100, 32 );
+
+   LedDriver_TurnAllOn( partial );
+
+   TEST_ASSERT_EQUAL_HEX32( 0xffffffff, registers[ 0 ] );
+   TEST_ASSERT_EQUAL_HEX32( 0xffffffff, registers[ 2 ] );
+   TEST_ASSERT_EQUAL_HEX32( 0x0000000f, registers[ 3 ] );
+   TEST_ASSERT_TRUE( LedDriver_AreAllOn( partial ) );
+
+   /* LED 101 does not exist */
+   LedDriver_TurnOn( partial, 101 );
+   TEST_ASSERT_EQUAL_HEX32( 0x0000000f, registers[ 3 ] );
+   TEST_ASSERT_EQUAL_STRING( "LED Driver: out-of-bounds LED", RuntimeErrorStub_GetLastError() );
+
+   LedDriver_Destroy( partial );
+}
+
+/* TEST 7 */
+TEST( LedDriverBank, SixtyFourBitRegisters )
+{
+   uint64_t registers[ 2 ] = { 0, 0 };
+   LedDriver wide = LedDriver_CreateBank( registers, 128, 64 );
+
+   LedDriver_TurnOn( wide, 64 );
+   LedDriver_TurnOn( wide, 128 );
+
+   TEST_ASSERT_TRUE( registers[ 0 ] == ( ( uint64_t ) 1 << 63 ) );
+   TEST_ASSERT_TRUE( registers[ 1 ] == ( ( uint64_t ) 1 << 63 ) );
+
+   LedDriver_Destroy( wide );
+}
+
+/* TEST 8 */
+TEST( LedDriverBank, OutOfBoundsLedsAreAlwaysOff )
+{
+   LedDriver_TurnAllOn( bank );
+
+   TEST_ASSERT_FALSE( LedDriver_IsOn( bank, 0 ) );
+   TEST_ASSERT_FALSE( LedDriver_IsOn( bank, BANK_LEDS + 1 ) );
+}
+
+/* TEST 9 */
+TEST( LedDriverBank, UnsupportedRegisterWidthIsRejected )
+{
+   uint16_t registers[ 2 ];
+
+   TEST_ASSERT_NULL( LedDriver_CreateBank( registers, 24, 12 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Driver: unsupported register width", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( 12, RuntimeErrorStub_GetLastParameter() );
+}
+
+/* TEST 10 */
+TEST( LedDriverBank, ApplyMaskAcrossWords )
+{
+   LedWord onMask[ BANK_LEDS / LED_WORD_BITS ]  = { 0 };
+   LedWord offMask[ BANK_LEDS / LED_WORD_BITS ] = { 0 };
+
+   /* LED 1 and the last LED on, LED 17 off */
+   onMask[ 0 ] = 1;
+   onMask[ BANK_LEDS / LED_WORD_BITS - 1 ] = ( LedWord ) 1 << ( LED_WORD_BITS - 1 );
+   offMask[ 0 ] = ( LedWord ) 1 << 16;
+
+   LedDriver_TurnOn( bank, 17 );
+   LedDriver_Apply( bank, onMask, offMask );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x0001, virtualRegisters[ 0 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0x0000, virtualRegisters[ 1 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0x8000, virtualRegisters[ 15 ] );
+}
+
+/* TEST 11 */
+TEST( LedDriverBank, FlushOnlyWritesChangedRegisters )
+{
+   uint32_t writes = LedDriver_GetRegisterWriteCount( bank );
+
+   /* LEDs in registers 0 and 12 change, the other 14 registers stay the same */
+   LedDriver_BeginUpdate( bank );
+   LedDriver_TurnAllOn( bank );
+   LedDriver_TurnAllOff( bank );
+   LedDriver_TurnOn( bank, 1 );
+   LedDriver_TurnOn( bank, 200 );
+   LedDriver_Flush( bank );
+
+   TEST_ASSERT_EQUAL( 2, LedDriver_GetRegisterWriteCount( bank ) - writes );
+   TEST_ASSERT_EQUAL_HEX16( 0x0001, virtualRegisters[ 0 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0x0080, virtualRegisters[ 12 ] );
+}
+
+/* TEST 12 */
+TEST( LedDriverBank, DriversInOneBlock )
+{
+   enum { BOARDS = 4, BOARD_LEDS = 100 };
+
+   uint32_t registers[ BOARDS ][ 4 ];
+   LedWord storage[ 64 ];
+   LedDriver boards[ BOARDS ];
+   size_t size = LedDriver_SizeOf( BOARD_LEDS );
+   int i; /* board index */
+
+   TEST_ASSERT_TRUE( BOARDS * size <= sizeof( storage ) );
+   TEST_ASSERT_EQUAL( 0, size % sizeof( LedWord ) );
+
+   /* every driver starts right where the previous one ends */
+   for ( i = 0; i < BOARDS; i++ )
+   {
+      registers[ i ][ 0 ] = 0xffffffff;
+      boards[ i ] = LedDriver_Init( ( char * ) storage + i * size, registers[ i ], BOARD_LEDS, 32 );
+      TEST_ASSERT_EQUAL_HEX32( 0, registers[ i ][ 0 ] );
+   }
+
+   /* the boards do not share any state */
+   for ( i = 0; i < BOARDS; i++ )
+   {
+      LedDriver_TurnAllOn( boards[ i ] );
+      LedDriver_TurnOff( boards[ i ], i + 1 );
+   }
+
+   for ( i = 0; i < BOARDS; i++ )
+   {
+      TEST_ASSERT_EQUAL_HEX32( ~( 1u << i ), registers[ i ][ 0 ] );
+      TEST_ASSERT_EQUAL_HEX32( 0x0000000f, registers[ i ][ 3 ] );
+   }
+
+   /* the storage is still checked like LedDriver_CreateBank() does */
+   TEST_ASSERT_NULL( LedDriver_Init( storage, registers[ 0 ], BOARD_LEDS, 12 ) );
+}
+
+TEST_GROUP_RUNNER( LedDriverBank )
+{
+   /* TEST 1 */
+   RUN_TEST_CASE( LedDriverBank, LedsOffAfterCreate );
+
+   /* TEST 2 */
+   RUN_TEST_CASE( LedDriverBank, LedsMapToTheirRegister );
+
+   /* TEST 3 */
+   RUN_TEST_CASE( LedDriverBank, SingleLedOnlyWritesItsRegister );
+
+   /* TEST 4 */
+   RUN_TEST_CASE( LedDriverBank, AllOnAndAllOff );
+
+   /* TEST 5 */
+   RUN_TEST_CASE( LedDriverBank, BankQueries );
+
+   /* TEST 6 */
+   RUN_TEST_CASE( LedDriverBank, PartialLastRegister );
+
+   /* TEST 7 */
+   RUN_TEST_CASE( LedDriverBank, SixtyFourBitRegisters );
+
+   /* TEST 8 */
+   RUN_TEST_CASE( LedDriverBank, OutOfBoundsLedsAreAlwaysOff );
+
+   /* TEST 9 */
+   RUN_TEST_CASE( LedDriverBank, UnsupportedRegisterWidthIsRejected );
+
+   /* TEST 10 */
+   RUN_TEST_CASE( LedDriverBank, ApplyMaskAcrossWords );
+
+   /* TEST 11 */
+   RUN_TEST_CASE( LedDriverBank, FlushOnlyWritesChangedRegisters );
+
+   /* TEST 12 */
+   RUN_TEST_CASE( LedDriverBank, DriversInOneBlock );
+}
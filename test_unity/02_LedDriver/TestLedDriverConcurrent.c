@@ -0,0 +1,233 @@
+/**
+ * @file    TestLedDriverConcurrent.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Test source file containing the test cases and test group runner for the LedDriver module
+ *          when several threads share the same driver (concurrent mode).
+ *
+ *          LED Driver Concurrent Tests:
+ *          ----------------------------
+ *          x - Concurrent mode behaves like the default mode on a single thread
+ *          x - No LED update is lost when several threads toggle LEDs of the same register
+ *          x - The register matches the image once all the threads are done
+ *          x - Leaving concurrent mode resynchronizes the registers
+ *          x - The register and the image hold the last state every thread left its LEDs in, whatever that state is
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "unity_fixture.h"
+#include "LedDriver.h"
+#include <pthread.h> /* pthread_create() / pthread_join() */
+
+enum { THREADS = 4, TOGGLES = 20000, BANK_LEDS = 64, BANK_WORDS = BANK_LEDS / LED_WORD_BITS };
+
+/* one 64-bit register holding 64 LEDs, every thread owns some of its bits */
+static uint64_t virtualRegister;
+
+/* driver of the bank, shared by all the threads */
+static LedDriver bank;
+
+/* LEDs owned by a thread: every LED whose ( ledNumber - 1 ) % THREADS equals the thread index */
+static void *toggleOwnLeds( void *arg )
+{
+   int thread = *( int * ) arg;
+   int i;
+   uint16_t ledNumber;
+
+   /* every toggle is a read-modify-write of the same image word the other threads are changing */
+   for ( i = 0; i < TOGGLES; i++ )
+   {
+      for ( ledNumber = thread + 1; ledNumber <= BANK_LEDS; ledNumber += THREADS )
+      {
+         LedDriver_TurnOn( bank, ledNumber );
+         LedDriver_TurnOff( bank, ledNumber );
+      }
+   }
+
+   /* leave all the owned LEDs on, so a single lost update shows up in the register */
+   for ( ledNumber = thread + 1; ledNumber <= BANK_LEDS; ledNumber += THREADS )
+   {
+      LedDriver_TurnOn( bank, ledNumber );
+   }
+
+   return NULL;
+}
+
+/* state every thread left its own LEDs in (index ledNumber - 1), only written by the owner of the LED */
+static BOOL lastState[ BANK_LEDS ];
+
+/* random updates of the owned LEDs (single LEDs and masks), leaving them in a random state */
+static void *updateOwnLedsRandomly( void *arg )
+{
+   int thread = *( int * ) arg;
+   uint32_t state = 2463534242u + ( uint32_t ) thread;
+   LedWord owned[ BANK_WORDS ] = { 0 };
+   LedWord onMask[ BANK_WORDS ];
+   LedWord offMask[ BANK_WORDS ];
+   uint16_t ledNumber;
+   int i;
+   int w;
+
+   for ( ledNumber = thread + 1; ledNumber <= BANK_LEDS; ledNumber += THREADS )
+   {
+      owned[ ( ledNumber - 1 ) / LED_WORD_BITS ] |= ( LedWord ) 1 << ( ( ledNumber - 1 ) % LED_WORD_BITS );
+   }
+
+   for ( i = 0; i < TOGGLES; i++ )
+   {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+
+      ledNumber = ( uint16_t ) ( ( state >> 8 ) % ( BANK_LEDS / THREADS ) * THREADS + thread + 1 );
+
+      switch ( state % 3 )
+      {
+         case 0:
+            LedDriver_TurnOn( bank, ledNumber );
+            lastState[ ledNumber - 1 ] = TRUE;
+            break;
+
+         case 1:
+            LedDriver_TurnOff( bank, ledNumber );
+            lastState[ ledNumber - 1 ] = FALSE;
+            break;
+
+         default:
+            for ( w = 0; w < BANK_WORDS; w++ )
+            {
+               onMask[ w ]  = ( LedWord ) ( ( ( uint64_t ) state << 32 ) | ( state * 2654435761u ) >> w ) & owned[ w ];
+               offMask[ w ] = ~onMask[ w ] & owned[ w ];
+            }
+
+            LedDriver_Apply( bank, onMask, offMask );
+
+            for ( ledNumber = thread + 1; ledNumber <= BANK_LEDS; ledNumber += THREADS )
+            {
+               lastState[ ledNumber - 1 ] = ( onMask[ ( ledNumber - 1 ) / LED_WORD_BITS ] >>
+                                              ( ( ledNumber - 1 ) % LED_WORD_BITS ) ) & 1;
+            }
+            break;
+      }
+   }
+
+   return NULL;
+}
+
+TEST_GROUP( LedDriverConcurrent );
+
+TEST_SETUP( LedDriverConcurrent )
+{
+   virtualRegister = ~( uint64_t ) 0;
+   bank = LedDriver_CreateBank( &virtualRegister, BANK_LEDS, 64 );
+   LedDriver_SetConcurrent( bank, TRUE );
+}
+
+TEST_TEAR_DOWN( LedDriverConcurrent )
+{
+   LedDriver_Destroy( bank );
+}
+
+/* TEST 1 */
+TEST( LedDriverConcurrent, SingleThreadBehavesAsUsual )
+{
+   LedWord onMask[ 1 ]  = { 0xf0 };
+   LedWord offMask[ 1 ] = { 0x30 };
+
+   LedDriver_TurnOn( bank, 1 );
+   LedDriver_TurnOn( bank, 64 );
+   TEST_ASSERT_TRUE( virtualRegister == ( ( ( uint64_t ) 1 << 63 ) | 1 ) );
+   TEST_ASSERT_TRUE( LedDriver_IsOn( bank, 64 ) );
+
+   LedDriver_TurnAllOff( bank );
+   LedDriver_Apply( bank, onMask, offMask );
+   TEST_ASSERT_TRUE( virtualRegister == 0xf0 );
+
+   LedDriver_ClearMask( bank, offMask );
+   TEST_ASSERT_TRUE( virtualRegister == 0xc0 );
+}
+
+/* TEST 2 */
+TEST( LedDriverConcurrent, NoUpdateIsLostAcrossThreads )
+{
+   pthread_t threads[ THREADS ];
+   int indexes[ THREADS ];
+   int i;
+
+   for ( i = 0; i < THREADS; i++ )
+   {
+      indexes[ i ] = i;
+      pthread_create( &threads[ i ], NULL, toggleOwnLeds, &indexes[ i ] );
+   }
+
+   for ( i = 0; i < THREADS; i++ )
+   {
+      pthread_join( threads[ i ], NULL );
+   }
+
+   /* both the image and the register hold the last update of every thread */
+   TEST_ASSERT_TRUE( LedDriver_AreAllOn( bank ) );
+   TEST_ASSERT_TRUE( virtualRegister == ~( uint64_t ) 0 );
+}
+
+/* TEST 3 */
+TEST( LedDriverConcurrent, LeavingConcurrentModeRewritesTheRegisters )
+{
+   LedDriver_TurnOn( bank, 5 );
+
+   /* someone scribbles over the register while the driver is shared */
+   virtualRegister = 0xdead;
+
+   LedDriver_SetConcurrent( bank, FALSE );
+
+   TEST_ASSERT_TRUE( virtualRegister == 0x10 );
+}
+
+/* TEST 4 */
+TEST( LedDriverConcurrent, RegisterMatchesImageAfterRandomUpdates )
+{
+   pthread_t threads[ THREADS ];
+   int indexes[ THREADS ];
+   uint64_t expected = 0;
+   int i;
+
+   for ( i = 0; i < THREADS; i++ )
+   {
+      indexes[ i ] = i;
+      pthread_create( &threads[ i ], NULL, updateOwnLedsRandomly, &indexes[ i ] );
+   }
+
+   for ( i = 0; i < THREADS; i++ )
+   {
+      pthread_join( threads[ i ], NULL );
+   }
+
+   /* a lost image update shows up in the image, a lost register write (or a stale one) in the register */
+   for ( i = 0; i < BANK_LEDS; i++ )
+   {
+      TEST_ASSERT_EQUAL( lastState[ i ], LedDriver_IsOn( bank, ( uint16_t ) ( i + 1 ) ) );
+
+      if ( lastState[ i ] )
+      {
+         expected |= ( uint64_t ) 1 << i;
+      }
+   }
+
+   TEST_ASSERT_TRUE( virtualRegister == expected );
+}
+
+TEST_GROUP_RUNNER( LedDriverConcurrent )
+{
+   /* TEST 1 */
+   RUN_TEST_CASE( LedDriverConcurrent, SingleThreadBehavesAsUsual );
+
+   /* TEST 2 */
+   RUN_TEST_CASE( LedDriverConcurrent, NoUpdateIsLostAcrossThreads );
+
+   /* TEST 3 */
+   RUN_TEST_CASE( LedDriverConcurrent, LeavingConcurrentModeRewritesTheRegisters );
+
+   /* TEST 4 */
+   RUN_TEST_CASE( LedDriverConcurrent, RegisterMatchesImageAfterRandomUpdates );
+}
@@ -0,0 +1,220 @@
+/**
+ * @file    TestLedMatrix.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Test source file containing the test cases and test group runner for the LedMatrix module
+ *          (double-buffered framebuffer of a LED matrix made of LedDriver rows).
+ *
+ *          LED Matrix Tests:
+ *          -----------------
+ *          x - All LEDs are off after the matrix is created
+ *          x - Drawing is only shown after a flip
+ *          x - A flip only pushes the rows that changed
+ *          x - Static content costs nothing
+ *          x - Pixels drawn and erased between two flips are not pushed
+ *          x - Clear only dirties the rows that had something drawn
+ *          x - Check out-of-bounds values
+ *          x - Rows of different widths
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "unity_fixture.h"
+#include "LedDriver.h"
+#include "LedMatrix.h"
+#include "RuntimeErrorStub.h"
+
+enum { ROWS = 8 };
+
+/* one 16-bit register per row, 16 columns */
+static uint16_t virtualRows[ ROWS ];
+
+/* drivers of the rows and the matrix */
+static LedDriver rows[ ROWS ];
+static LedMatrix matrix;
+
+/* total number of register writes of all the rows */
+static uint32_t registerWrites( void )
+{
+   int i;
+   uint32_t writes = 0;
+
+   for ( i = 0; i < ROWS; i++ )
+   {
+      writes += LedDriver_GetRegisterWriteCount( rows[ i ] );
+   }
+
+   return writes;
+}
+
+TEST_GROUP( LedMatrix );
+
+TEST_SETUP( LedMatrix )
+{
+   int i;
+
+   for ( i = 0; i < ROWS; i++ )
+   {
+      virtualRows[ i ] = 0xffff;
+      rows[ i ] = LedDriver_Create( &virtualRows[ i ] );
+   }
+
+   matrix = LedMatrix_Create( rows, ROWS );
+}
+
+TEST_TEAR_DOWN( LedMatrix )
+{
+   int i;
+
+   LedMatrix_Destroy( matrix );
+
+   for ( i = 0; i < ROWS; i++ )
+   {
+      LedDriver_Destroy( rows[ i ] );
+   }
+}
+
+/* TEST 1 */
+TEST( LedMatrix, LedsOffAfterCreate )
+{
+   int i;
+
+   for ( i = 0; i < ROWS; i++ )
+   {
+      TEST_ASSERT_EQUAL_HEX16( 0, virtualRows[ i ] );
+   }
+
+   TEST_ASSERT_FALSE( LedMatrix_GetPixel( matrix, 1, 1 ) );
+   TEST_ASSERT_EQUAL( 0, LedMatrix_Flip( matrix ) );
+}
+
+/* TEST 2 */
+TEST( LedMatrix, DrawingIsShownOnFlip )
+{
+   LedMatrix_SetPixel( matrix, 2, 1, TRUE );
+   LedMatrix_SetPixel( matrix, 2, 16, TRUE );
+
+   TEST_ASSERT_TRUE( LedMatrix_GetPixel( matrix, 2, 16 ) );
+   TEST_ASSERT_EQUAL_HEX16( 0, virtualRows[ 1 ] );
+
+   LedMatrix_Flip( matrix );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x8001, virtualRows[ 1 ] );
+}
+
+/* TEST 3 */
+TEST( LedMatrix, FlipOnlyPushesChangedRows )
+{
+   uint32_t writes = registerWrites();
+
+   /* mark a row the matrix has no reason to touch */
+   virtualRows[ 4 ] = 0xbeef;
+
+   LedMatrix_SetPixel( matrix, 1, 3, TRUE );
+   LedMatrix_SetPixel( matrix, 8, 4, TRUE );
+
+   TEST_ASSERT_EQUAL( 2, LedMatrix_Flip( matrix ) );
+   TEST_ASSERT_EQUAL( 2, registerWrites() - writes );
+   TEST_ASSERT_EQUAL_HEX16( 0x0004, virtualRows[ 0 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0x0008, virtualRows[ 7 ] );
+   TEST_ASSERT_EQUAL_HEX16( 0xbeef, virtualRows[ 4 ] );
+}
+
+/* TEST 4 */
+TEST( LedMatrix, StaticContentCostsNothing )
+{
+   uint32_t writes;
+
+   LedMatrix_SetPixel( matrix, 5, 5, TRUE );
+   LedMatrix_Flip( matrix );
+   writes = registerWrites();
+
+   /* drawing what is already shown changes nothing */
+   LedMatrix_SetPixel( matrix, 5, 5, TRUE );
+
+   TEST_ASSERT_EQUAL( 0, LedMatrix_Flip( matrix ) );
+   TEST_ASSERT_EQUAL( 0, LedMatrix_Flip( matrix ) );
+   TEST_ASSERT_EQUAL( writes, registerWrites() );
+}
+
+/* TEST 5 */
+TEST( LedMatrix, ErasedBeforeFlipIsNotPushed )
+{
+   uint32_t writes = registerWrites();
+
+   LedMatrix_SetPixel( matrix, 3, 7, TRUE );
+   LedMatrix_SetPixel( matrix, 3, 7, FALSE );
+
+   TEST_ASSERT_EQUAL( 0, LedMatrix_Flip( matrix ) );
+   TEST_ASSERT_EQUAL( writes, registerWrites() );
+}
+
+/* TEST 6 */
+TEST( LedMatrix, ClearOnlyDirtiesLitRows )
+{
+   LedMatrix_SetPixel( matrix, 6, 2, TRUE );
+   LedMatrix_Flip( matrix );
+
+   LedMatrix_Clear( matrix );
+
+   TEST_ASSERT_EQUAL( 1, LedMatrix_Flip( matrix ) );
+   TEST_ASSERT_EQUAL_HEX16( 0, virtualRows[ 5 ] );
+}
+
+/* TEST 7 */
+TEST( LedMatrix, OutOfBoundsPixelsAreRejected )
+{
+   LedMatrix_SetPixel( matrix, ROWS + 1, 1, TRUE );
+
+   TEST_ASSERT_EQUAL_STRING( "LED Matrix: out-of-bounds pixel", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( ROWS + 1, RuntimeErrorStub_GetLastParameter() );
+
+   LedMatrix_SetPixel( matrix, 1, 17, TRUE );
+
+   TEST_ASSERT_FALSE( LedMatrix_GetPixel( matrix, 1, 17 ) );
+   TEST_ASSERT_EQUAL( 0, LedMatrix_Flip( matrix ) );
+}
+
+/* TEST 8 */
+TEST( LedMatrix, RowsOfDifferentWidthsAreRejected )
+{
+   uint16_t registers[ 2 ] = { 0, 0 };
+   LedDriver mixed[ 2 ];
+
+   mixed[ 0 ] = LedDriver_CreateBank( &registers[ 0 ], 16, 16 );
+   mixed[ 1 ] = LedDriver_CreateBank( &registers[ 1 ], 8, 8 );
+
+   TEST_ASSERT_NULL( LedMatrix_Create( mixed, 2 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Matrix: rows of different widths", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( 2, RuntimeErrorStub_GetLastParameter() );
+
+   LedDriver_Destroy( mixed[ 0 ] );
+   LedDriver_Destroy( mixed[ 1 ] );
+}
+
+TEST_GROUP_RUNNER( LedMatrix )
+{
+   /* TEST 1 */
+   RUN_TEST_CASE( LedMatrix, LedsOffAfterCreate );
+
+   /* TEST 2 */
+   RUN_TEST_CASE( LedMatrix, DrawingIsShownOnFlip );
+
+   /* TEST 3 */
+   RUN_TEST_CASE( LedMatrix, FlipOnlyPushesChangedRows );
+
+   /* TEST 4 */
+   RUN_TEST_CASE( LedMatrix, StaticContentCostsNothing );
+
+   /* TEST 5 */
+   RUN_TEST_CASE( LedMatrix, ErasedBeforeFlipIsNotPushed );
+
+   /* TEST 6 */
+   RUN_TEST_CASE( LedMatrix, ClearOnlyDirtiesLitRows );
+
+   /* TEST 7 */
+   RUN_TEST_CASE( LedMatrix, OutOfBoundsPixelsAreRejected );
+
+   /* TEST 8 */
+   RUN_TEST_CASE( LedMatrix, RowsOfDifferentWidthsAreRejected );
+}
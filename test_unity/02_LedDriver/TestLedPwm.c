@@ -0,0 +1,183 @@
+/**
+ * @file    TestLedPwm.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Test source file containing the test cases and test group runner for the LedPwm module
+ *          (software PWM brightness on top of the LedDriver).
+ *
+ *          LED PWM Tests:
+ *          --------------
+ *          x - All LEDs are off after the PWM is created
+ *          x - Full brightness keeps a LED on during the whole period
+ *          x - The time a LED is on follows the gamma corrected brightness
+ *          x - LEDs of the same bank have independent brightness
+ *          x - The hardware is updated at most once per plane
+ *          x - Check out-of-bounds values
+ *          x - A new brightness waits for the next period
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "unity_fixture.h"
+#include "LedDriver.h"
+#include "LedPwm.h"
+#include "RuntimeErrorStub.h"
+
+enum { BANK_LEDS = 128, BANK_REGISTERS = BANK_LEDS / 32 };
+
+/* four 32-bit registers holding 128 LEDs */
+static uint32_t virtualRegisters[ BANK_REGISTERS ];
+
+/* driver of the bank and its PWM */
+static LedDriver bank;
+static LedPwm pwm;
+
+/* run a whole PWM period and return for how many ticks the LED was on */
+static int ticksOn( uint16_t ledNumber )
+{
+   int tick;
+   int on = 0;
+
+   for ( tick = 0; tick < LEDPWM_TICKS_PER_PERIOD; tick++ )
+   {
+      LedPwm_Tick( pwm );
+      on += LedDriver_IsOn( bank, ledNumber );
+   }
+
+   return on;
+}
+
+TEST_GROUP( LedPwm );
+
+TEST_SETUP( LedPwm )
+{
+   bank = LedDriver_CreateBank( virtualRegisters, BANK_LEDS, 32 );
+   pwm  = LedPwm_Create( bank );
+}
+
+TEST_TEAR_DOWN( LedPwm )
+{
+   LedPwm_Destroy( pwm );
+   LedDriver_Destroy( bank );
+}
+
+/* TEST 1 */
+TEST( LedPwm, LedsOffAfterCreate )
+{
+   TEST_ASSERT_EQUAL( 0, LedPwm_GetBrightness( pwm, 1 ) );
+   TEST_ASSERT_EQUAL( 0, ticksOn( 1 ) );
+   TEST_ASSERT_TRUE( LedDriver_AreAllOff( bank ) );
+}
+
+/* TEST 2 */
+TEST( LedPwm, FullBrightnessIsAlwaysOn )
+{
+   LedPwm_SetBrightness( pwm, 128, 255 );
+
+   TEST_ASSERT_EQUAL( LEDPWM_TICKS_PER_PERIOD, ticksOn( 128 ) );
+   TEST_ASSERT_EQUAL( 255, LedPwm_GetBrightness( pwm, 128 ) );
+}
+
+/* TEST 3 */
+TEST( LedPwm, DutyCycleFollowsGammaCorrectedBrightness )
+{
+   /* with a gamma of 2.2, half brightness is on for 56 out of 255 ticks and a quarter for 12 */
+   LedPwm_SetBrightness( pwm, 7, 128 );
+   TEST_ASSERT_EQUAL( 56, ticksOn( 7 ) );
+
+   LedPwm_SetBrightness( pwm, 7, 64 );
+   TEST_ASSERT_EQUAL( 12, ticksOn( 7 ) );
+}
+
+/* TEST 4 */
+TEST( LedPwm, LedsHaveIndependentBrightness )
+{
+   LedPwm_SetBrightness( pwm, 1, 255 );
+   LedPwm_SetBrightness( pwm, 2, 128 );
+   LedPwm_SetBrightness( pwm, 100, 64 );
+
+   /* three LEDs, three full periods, the LEDs never affect each other */
+   TEST_ASSERT_EQUAL( 255, ticksOn( 1 ) );
+   TEST_ASSERT_EQUAL( 56, ticksOn( 2 ) );
+   TEST_ASSERT_EQUAL( 12, ticksOn( 100 ) );
+   TEST_ASSERT_EQUAL( 0, ticksOn( 3 ) );
+}
+
+/* TEST 5 */
+TEST( LedPwm, AtMostOneHardwareUpdatePerPlane )
+{
+   uint32_t writes;
+   uint16_t ledNumber;
+
+   /* every LED of the first register at half brightness */
+   for ( ledNumber = 1; ledNumber <= 32; ledNumber++ )
+   {
+      LedPwm_SetBrightness( pwm, ledNumber, 128 );
+   }
+
+   writes = LedDriver_GetRegisterWriteCount( bank );
+   ticksOn( 1 );
+
+   /* 8 planes in a period, and only the register of the dimmed LEDs ever changes */
+   TEST_ASSERT_TRUE( LedDriver_GetRegisterWriteCount( bank ) - writes <= 8 );
+   TEST_ASSERT_EQUAL_HEX32( 0, virtualRegisters[ 1 ] );
+}
+
+/* TEST 6 */
+TEST( LedPwm, OutOfBoundsLedsAreRejected )
+{
+   LedPwm_SetBrightness( pwm, BANK_LEDS + 1, 200 );
+
+   TEST_ASSERT_EQUAL_STRING( "LED PWM: out-of-bounds LED", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( BANK_LEDS + 1, RuntimeErrorStub_GetLastParameter() );
+   TEST_ASSERT_EQUAL( 0, LedPwm_GetBrightness( pwm, BANK_LEDS + 1 ) );
+}
+
+/* TEST 7 */
+TEST( LedPwm, NewBrightnessWaitsForTheNextPeriod )
+{
+   int tick;
+   int on = 0;
+
+   LedPwm_SetBrightness( pwm, 5, 128 );
+
+   /* half a period at half brightness, then full brightness is set */
+   for ( tick = 0; tick < LEDPWM_TICKS_PER_PERIOD; tick++ )
+   {
+      if ( tick == LEDPWM_TICKS_PER_PERIOD / 2 )
+      {
+         LedPwm_SetBrightness( pwm, 5, 255 );
+      }
+
+      LedPwm_Tick( pwm );
+      on += LedDriver_IsOn( bank, 5 );
+   }
+
+   /* the whole period kept the old duty, the next one shows the new one */
+   TEST_ASSERT_EQUAL( 56, on );
+   TEST_ASSERT_EQUAL( LEDPWM_TICKS_PER_PERIOD, ticksOn( 5 ) );
+}
+
+TEST_GROUP_RUNNER( LedPwm )
+{
+   /* TEST 1 */
+   RUN_TEST_CASE( LedPwm, LedsOffAfterCreate );
+
+   /* TEST 2 */
+   RUN_TEST_CASE( LedPwm, FullBrightnessIsAlwaysOn );
+
+   /* TEST 3 */
+   RUN_TEST_CASE( LedPwm, DutyCycleFollowsGammaCorrectedBrightness );
+
+   /* TEST 4 */
+   RUN_TEST_CASE( LedPwm, LedsHaveIndependentBrightness );
+
+   /* TEST 5 */
+   RUN_TEST_CASE( LedPwm, AtMostOneHardwareUpdatePerPlane );
+
+   /* TEST 6 */
+   RUN_TEST_CASE( LedPwm, OutOfBoundsLedsAreRejected );
+
+   /* TEST 7 */
+   RUN_TEST_CASE( LedPwm, NewBrightnessWaitsForTheNextPeriod );
+}
@@ -0,0 +1,175 @@
+/**
+ * @file    TestLedRegisterPage.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Test source file containing the test cases and test group runner for the LedRegisterPage module
+ *          (the memory a LedDriver writes its registers to).
+ *
+ *          LED Register Page Tests:
+ *          ------------------------
+ *          x - In-process memory backs a driver
+ *          x - A mapped file backs a driver
+ *          x - Writes are visible to another process (through the file)
+ *          x - Mapping fails for a bad path
+ *          x - Mapping never shrinks a bigger file
+ *          x - Sizing or mapping the file fails with the reason (errno)
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "unity_fixture.h"
+#include "LedDriver.h"
+#include "LedRegisterPage.h"
+#include "RuntimeErrorStub.h"
+#include <errno.h>    /* ENOENT / EINVAL */
+#include <stdlib.h>   /* mkstemp() */
+#include <string.h>   /* strcpy() */
+#include <unistd.h>   /* fork() / pread() / close() / unlink() / _exit() */
+#include <fcntl.h>    /* open() */
+#include <sys/stat.h> /* stat() */
+#include <sys/wait.h> /* waitpid() */
+
+/* file standing in for the register page */
+static char path[] = "/tmp/LedRegisterPageXXXXXX";
+
+TEST_GROUP( LedRegisterPage );
+
+TEST_SETUP( LedRegisterPage )
+{
+   /* create a unique (empty) file for every TEST() */
+   strcpy( path, "/tmp/LedRegisterPageXXXXXX" );
+   close( mkstemp( path ) );
+}
+
+TEST_TEAR_DOWN( LedRegisterPage )
+{
+   unlink( path );
+}
+
+/* TEST 1 */
+TEST( LedRegisterPage, InMemoryPageBacksADriver )
+{
+   LedRegisterPage page = LedRegisterPage_CreateInMemory( 32 );
+   LedDriver bank = LedDriver_CreateBank( LedRegisterPage_GetAddress( page ), 256, 16 );
+   volatile uint16_t *registers = LedRegisterPage_GetAddress( page );
+
+   LedDriver_TurnOn( bank, 17 );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x0001, registers[ 1 ] );
+
+   LedDriver_Destroy( bank );
+   LedRegisterPage_Destroy( page );
+}
+
+/* TEST 2 */
+TEST( LedRegisterPage, MappedFileBacksADriver )
+{
+   LedRegisterPage page = LedRegisterPage_MapFile( path, 4096 );
+   LedDriver bank = LedDriver_CreateBank( LedRegisterPage_GetAddress( page ), 64, 32 );
+   uint32_t fromFile = 0;
+   int fd;
+
+   LedDriver_TurnOn( bank, 1 );
+   LedDriver_TurnOn( bank, 32 );
+
+   /* read the first register back through the file, not through the mapping */
+   fd = open( path, O_RDONLY );
+   TEST_ASSERT_EQUAL( sizeof( fromFile ), pread( fd, &fromFile, sizeof( fromFile ), 0 ) );
+   close( fd );
+
+   TEST_ASSERT_EQUAL_HEX32( 0x80000001, fromFile );
+
+   LedDriver_Destroy( bank );
+   LedRegisterPage_Destroy( page );
+}
+
+/* TEST 3 */
+TEST( LedRegisterPage, WritesAreVisibleToAnotherProcess )
+{
+   LedRegisterPage page = LedRegisterPage_MapFile( path, 4096 );
+   LedDriver bank = LedDriver_CreateBank( LedRegisterPage_GetAddress( page ), 16, 16 );
+   int status = -1;
+   pid_t child;
+
+   LedDriver_TurnOn( bank, 4 );
+   LedDriver_TurnOn( bank, 16 );
+
+   /* a second process maps the same file and reports what the register holds through its exit status */
+   child = fork();
+
+   if ( child == 0 )
+   {
+      LedRegisterPage view = LedRegisterPage_MapFile( path, 4096 );
+      volatile uint16_t *registers = LedRegisterPage_GetAddress( view );
+
+      _exit( registers[ 0 ] == 0x8008 ? 0 : 1 );
+   }
+
+   waitpid( child, &status, 0 );
+
+   TEST_ASSERT_TRUE( WIFEXITED( status ) );
+   TEST_ASSERT_EQUAL( 0, WEXITSTATUS( status ) );
+
+   LedDriver_Destroy( bank );
+   LedRegisterPage_Destroy( page );
+}
+
+/* TEST 4 */
+TEST( LedRegisterPage, MappingFailsForBadPath )
+{
+   TEST_ASSERT_NULL( LedRegisterPage_MapFile( "/nonexistent/directory/leds", 4096 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Register Page: cannot open file", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( ENOENT, RuntimeErrorStub_GetLastParameter() );
+}
+
+/* TEST 5 */
+TEST( LedRegisterPage, MappingNeverShrinksTheFile )
+{
+   LedRegisterPage page = LedRegisterPage_MapFile( path, 8192 );
+   struct stat status;
+
+   LedRegisterPage_Destroy( page );
+
+   /* a smaller page maps the start of the file, the rest of it stays */
+   page = LedRegisterPage_MapFile( path, 4096 );
+   stat( path, &status );
+
+   TEST_ASSERT_EQUAL( 8192, status.st_size );
+
+   LedRegisterPage_Destroy( page );
+}
+
+/* TEST 6 */
+TEST( LedRegisterPage, SizingOrMappingFailureReportsErrno )
+{
+   /* no file can be that big (the size does not even fit a file offset) */
+   TEST_ASSERT_NULL( LedRegisterPage_MapFile( path, ( size_t ) -1 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Register Page: cannot size file", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( EINVAL, RuntimeErrorStub_GetLastParameter() );
+
+   /* an empty mapping is refused */
+   TEST_ASSERT_NULL( LedRegisterPage_MapFile( path, 0 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Register Page: cannot map file", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( EINVAL, RuntimeErrorStub_GetLastParameter() );
+}
+
+TEST_GROUP_RUNNER( LedRegisterPage )
+{
+   /* TEST 1 */
+   RUN_TEST_CASE( LedRegisterPage, InMemoryPageBacksADriver );
+
+   /* TEST 2 */
+   RUN_TEST_CASE( LedRegisterPage, MappedFileBacksADriver );
+
+   /* TEST 3 */
+   RUN_TEST_CASE( LedRegisterPage, WritesAreVisibleToAnotherProcess );
+
+   /* TEST 4 */
+   RUN_TEST_CASE( LedRegisterPage, MappingFailsForBadPath );
+
+   /* TEST 5 */
+   RUN_TEST_CASE( LedRegisterPage, MappingNeverShrinksTheFile );
+
+   /* TEST 6 */
+   RUN_TEST_CASE( LedRegisterPage, SizingOrMappingFailureReportsErrno );
+}
@@ -0,0 +1,187 @@
+/**
+ * @file    TestLedSequencer.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Test source file containing the test cases and test group runner for the LedSequencer module
+ *          (animations played on a LedDriver bank from a queue of precomputed frames).
+ *
+ *          LED Sequencer Tests:
+ *          --------------------
+ *          x - Nothing is played after the sequencer is created
+ *          x - A queued frame is shown for its number of ticks
+ *          x - Frames are played in the order they were queued
+ *          x - The last frame stays on when the queue runs out
+ *          x - A frame costs one hardware update no matter how many LEDs change
+ *          x - The queue has a limited capacity
+ *          x - Check out-of-bounds values
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "unity_fixture.h"
+#include "LedDriver.h"
+#include "LedSequencer.h"
+#include "RuntimeErrorStub.h"
+
+enum { FRAMES = 4, QUEUE_CAPACITY = 8 };
+enum { BLANK, EVEN_LEDS, ODD_LEDS, ALL_LEDS };
+
+/* virtual 16-bit register holding a 16 LED board */
+static uint16_t virtualLeds;
+
+/* driver of the board and its sequencer */
+static LedDriver leds;
+static LedSequencer sequencer;
+
+TEST_GROUP( LedSequencer );
+
+TEST_SETUP( LedSequencer )
+{
+   LedWord evenLeds = 0xaaaa; /* LEDs 2, 4 ... 16 */
+   LedWord oddLeds  = 0x5555; /* LEDs 1, 3 ... 15 */
+   LedWord allLeds  = 0xffff;
+
+   leds = LedDriver_Create( &virtualLeds );
+   sequencer = LedSequencer_Create( leds, FRAMES, QUEUE_CAPACITY );
+
+   LedSequencer_DefineFrame( sequencer, EVEN_LEDS, &evenLeds );
+   LedSequencer_DefineFrame( sequencer, ODD_LEDS, &oddLeds );
+   LedSequencer_DefineFrame( sequencer, ALL_LEDS, &allLeds );
+}
+
+TEST_TEAR_DOWN( LedSequencer )
+{
+   LedSequencer_Destroy( sequencer );
+   LedDriver_Destroy( leds );
+}
+
+/* TEST 1 */
+TEST( LedSequencer, IdleAfterCreate )
+{
+   TEST_ASSERT_TRUE( LedSequencer_IsIdle( sequencer ) );
+
+   LedSequencer_Tick( sequencer );
+
+   TEST_ASSERT_EQUAL_HEX16( 0, virtualLeds );
+}
+
+/* TEST 2 */
+TEST( LedSequencer, FrameIsShownForItsTicks )
+{
+   LedSequencer_Queue( sequencer, ALL_LEDS, 3 );
+   LedSequencer_Queue( sequencer, BLANK, 1 );
+
+   LedSequencer_Tick( sequencer );
+   TEST_ASSERT_EQUAL_HEX16( 0xffff, virtualLeds );
+   LedSequencer_Tick( sequencer );
+   LedSequencer_Tick( sequencer );
+   TEST_ASSERT_EQUAL_HEX16( 0xffff, virtualLeds );
+
+   /* fourth tick: the blank frame starts */
+   LedSequencer_Tick( sequencer );
+   TEST_ASSERT_EQUAL_HEX16( 0, virtualLeds );
+}
+
+/* TEST 3 */
+TEST( LedSequencer, FramesArePlayedInOrder )
+{
+   LedSequencer_Queue( sequencer, EVEN_LEDS, 1 );
+   LedSequencer_Queue( sequencer, ODD_LEDS, 1 );
+   LedSequencer_Queue( sequencer, EVEN_LEDS, 1 );
+
+   LedSequencer_Tick( sequencer );
+   TEST_ASSERT_EQUAL_HEX16( 0xaaaa, virtualLeds );
+   LedSequencer_Tick( sequencer );
+   TEST_ASSERT_EQUAL_HEX16( 0x5555, virtualLeds );
+   LedSequencer_Tick( sequencer );
+   TEST_ASSERT_EQUAL_HEX16( 0xaaaa, virtualLeds );
+   TEST_ASSERT_TRUE( LedSequencer_IsIdle( sequencer ) );
+}
+
+/* TEST 4 */
+TEST( LedSequencer, LastFrameStaysOn )
+{
+   LedSequencer_Queue( sequencer, ODD_LEDS, 1 );
+
+   LedSequencer_Tick( sequencer );
+   LedSequencer_Tick( sequencer );
+   LedSequencer_Tick( sequencer );
+
+   TEST_ASSERT_EQUAL_HEX16( 0x5555, virtualLeds );
+}
+
+/* TEST 5 */
+TEST( LedSequencer, OneHardwareUpdatePerFrame )
+{
+   uint32_t writes = LedDriver_GetRegisterWriteCount( leds );
+
+   /* 16 LEDs change on every frame, the frames last 10 ticks */
+   LedSequencer_Queue( sequencer, EVEN_LEDS, 10 );
+   LedSequencer_Queue( sequencer, ODD_LEDS, 10 );
+
+   while ( !LedSequencer_IsIdle( sequencer ) )
+   {
+      LedSequencer_Tick( sequencer );
+   }
+
+   TEST_ASSERT_EQUAL( 2, LedDriver_GetRegisterWriteCount( leds ) - writes );
+}
+
+/* TEST 6 */
+TEST( LedSequencer, QueueHasLimitedCapacity )
+{
+   int i;
+
+   /* a whole animation can be queued ahead of time, up to the queue capacity */
+   for ( i = 0; i < QUEUE_CAPACITY; i++ )
+   {
+      TEST_ASSERT_TRUE( LedSequencer_Queue( sequencer, i % FRAMES, 1 ) );
+   }
+
+   TEST_ASSERT_FALSE( LedSequencer_Queue( sequencer, BLANK, 1 ) );
+
+   /* once a frame is played there is room for another one */
+   LedSequencer_Tick( sequencer );
+   TEST_ASSERT_TRUE( LedSequencer_Queue( sequencer, BLANK, 1 ) );
+}
+
+/* TEST 7 */
+TEST( LedSequencer, OutOfBoundsValuesAreRejected )
+{
+   TEST_ASSERT_FALSE( LedSequencer_Queue( sequencer, FRAMES, 1 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Sequencer: unknown frame", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( FRAMES, RuntimeErrorStub_GetLastParameter() );
+
+   TEST_ASSERT_FALSE( LedSequencer_Queue( sequencer, ALL_LEDS, 0 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Sequencer: empty frame duration", RuntimeErrorStub_GetLastError() );
+
+   TEST_ASSERT_TRUE( LedSequencer_IsIdle( sequencer ) );
+
+   TEST_ASSERT_NULL( LedSequencer_Create( leds, FRAMES, 0 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Sequencer: empty queue", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( 0, RuntimeErrorStub_GetLastParameter() );
+}
+
+TEST_GROUP_RUNNER( LedSequencer )
+{
+   /* TEST 1 */
+   RUN_TEST_CASE( LedSequencer, IdleAfterCreate );
+
+   /* TEST 2 */
+   RUN_TEST_CASE( LedSequencer, FrameIsShownForItsTicks );
+
+   /* TEST 3 */
+   RUN_TEST_CASE( LedSequencer, FramesArePlayedInOrder );
+
+   /* TEST 4 */
+   RUN_TEST_CASE( LedSequencer, LastFrameStaysOn );
+
+   /* TEST 5 */
+   RUN_TEST_CASE( LedSequencer, OneHardwareUpdatePerFrame );
+
+   /* TEST 6 */
+   RUN_TEST_CASE( LedSequencer, QueueHasLimitedCapacity );
+
+   /* TEST 7 */
+   RUN_TEST_CASE( LedSequencer, OutOfBoundsValuesAreRejected );
+}
@@ -0,0 +1,227 @@
+/**
+ * @file    TestLedTrace.c
+ * @author  Julio Cesar Bernal Mendez
+ * @brief   Test source file containing the test cases and test group runner for the LedTrace module
+ *          (ring of the LED image changes recorded by a LedDriver).
+ *
+ *          LED Trace Tests:
+ *          ----------------
+ *          x - Nothing is recorded after the trace is created
+ *          x - A change records its time, word, old and new image and caller
+ *          x - Operations that change nothing are not recorded
+ *          x - The ring keeps the most recent changes
+ *          x - Detaching the trace stops the recording
+ *          x - The trace is dumped oldest change first
+ *          x - The trace is dumped before a runtime error
+ *          x - Unsupported capacity
+ *          x - Entries carry their record number, an entry being written is reported as such
+ *
+ * @version 0.1
+ * @date    2026-10-18
+ */
+
+#include "unity_fixture.h"
+#include "LedDriver.h"
+#include "LedTrace.h"
+#include "RuntimeErrorStub.h"
+#include "Utils.h"           /* FormatOutput() */
+#include "FormatOutputSpy.h" /* FormatOutputSpy() */
+#include <string.h>          /* strstr() */
+
+enum { TRACE_CAPACITY = 4 };
+
+/* virtual 16-bit register holding a 16 LED board */
+static uint16_t virtualLeds;
+
+/* driver of the board and its trace */
+static LedDriver leds;
+static LedTrace trace;
+
+/* production time source and output, restored after every TEST() */
+static uint64_t ( *savedGetTimestamp )( void );
+static int ( *savedFormatOutput )( const char *, ... );
+
+/* fake time source, every timestamp is 10 ns after the previous one */
+static uint64_t fakeTime;
+
+static uint64_t FakeTimestamp( void )
+{
+   return fakeTime += 10;
+}
+
+/* fake time source that reads the entry being recorded (it is called halfway through LedTrace_Record()) */
+static LedTraceEntry entryBeingWritten;
+
+static uint64_t ReadingTimestamp( void )
+{
+   entryBeingWritten = LedTrace_GetEntry( trace, LedTrace_GetCount( trace ) - 1 );
+
+   return FakeTimestamp();
+}
+
+TEST_GROUP( LedTrace );
+
+TEST_SETUP( LedTrace )
+{
+   savedGetTimestamp = LedTrace_GetTimestamp;
+   savedFormatOutput = FormatOutput;
+   LedTrace_GetTimestamp = FakeTimestamp;
+   FormatOutput = FormatOutputSpy;
+   FormatOutputSpy_Create( 400 );
+   fakeTime = 0;
+
+   leds  = LedDriver_Create( &virtualLeds );
+   trace = LedTrace_Create( TRACE_CAPACITY );
+   LedDriver_SetTrace( leds, trace );
+}
+
+TEST_TEAR_DOWN( LedTrace )
+{
+   LedDriver_Destroy( leds );
+   LedTrace_Destroy( trace );
+   FormatOutputSpy_Destroy();
+   LedTrace_GetTimestamp = savedGetTimestamp;
+   FormatOutput = savedFormatOutput;
+}
+
+/* TEST 1 */
+TEST( LedTrace, NothingRecordedAfterCreate )
+{
+   TEST_ASSERT_EQUAL( 0, LedTrace_GetCount( trace ) );
+}
+
+/* TEST 2 */
+TEST( LedTrace, ChangeIsRecorded )
+{
+   LedTraceEntry entry;
+
+   LedDriver_TurnOn( leds, 3 );
+   LedDriver_TurnOn( leds, 16 );
+
+   TEST_ASSERT_EQUAL( 2, LedTrace_GetCount( trace ) );
+
+   entry = LedTrace_GetEntry( trace, 1 );
+   TEST_ASSERT_EQUAL( 20, entry.timestamp );
+   TEST_ASSERT_EQUAL( 0, entry.word );
+   TEST_ASSERT_EQUAL_HEX32( 0x0004, entry.oldImage );
+   TEST_ASSERT_EQUAL_HEX32( 0x8004, entry.newImage );
+   TEST_ASSERT_NOT_NULL( entry.caller );
+}
+
+/* TEST 3 */
+TEST( LedTrace, UnchangedImageIsNotRecorded )
+{
+   LedDriver_TurnOff( leds, 5 );
+   LedDriver_TurnAllOff( leds );
+   LedDriver_TurnOn( leds, 5 );
+   LedDriver_TurnOn( leds, 5 );
+
+   TEST_ASSERT_EQUAL( 1, LedTrace_GetCount( trace ) );
+}
+
+/* TEST 4 */
+TEST( LedTrace, RingKeepsTheMostRecentChanges )
+{
+   uint16_t ledNumber;
+
+   /* six changes into a four entry ring */
+   for ( ledNumber = 1; ledNumber <= 6; ledNumber++ )
+   {
+      LedDriver_TurnOn( leds, ledNumber );
+   }
+
+   TEST_ASSERT_EQUAL( TRACE_CAPACITY, LedTrace_GetCount( trace ) );
+   /* the first two changes (LEDs 1 and 2) were overwritten */
+   TEST_ASSERT_EQUAL_HEX32( 0x0003, LedTrace_GetEntry( trace, 0 ).oldImage );
+   TEST_ASSERT_EQUAL_HEX32( 0x0007, LedTrace_GetEntry( trace, 0 ).newImage );
+   TEST_ASSERT_EQUAL_HEX32( 0x003f, LedTrace_GetEntry( trace, 3 ).newImage );
+   TEST_ASSERT_EQUAL( 60, LedTrace_GetEntry( trace, 3 ).timestamp );
+}
+
+/* TEST 5 */
+TEST( LedTrace, DetachedTraceRecordsNothing )
+{
+   LedDriver_SetTrace( leds, NULL );
+   LedDriver_TurnAllOn( leds );
+
+   TEST_ASSERT_EQUAL( 0, LedTrace_GetCount( trace ) );
+}
+
+/* TEST 6 */
+TEST( LedTrace, DumpOldestFirst )
+{
+   const char *output;
+
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnAllOn( leds );
+   LedTrace_Dump( trace );
+
+   output = FormatOutputSpy_GetOutput();
+
+   TEST_ASSERT_NOT_NULL( strstr( output, "LED trace (2 entries):\n10: word 0 0x0 -> 0x1 (caller " ) );
+   TEST_ASSERT_NOT_NULL( strstr( output, "20: word 0 0x1 -> 0xffff (caller " ) );
+   TEST_ASSERT_TRUE( strstr( output, "10: word" ) < strstr( output, "20: word" ) );
+}
+
+/* TEST 7 */
+TEST( LedTrace, DumpedBeforeRuntimeError )
+{
+   LedDriver_TurnOn( leds, 9 );
+   LedDriver_TurnOn( leds, 17 );
+
+   TEST_ASSERT_EQUAL_STRING( "LED Driver: out-of-bounds LED", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_NOT_NULL( strstr( FormatOutputSpy_GetOutput(), "10: word 0 0x0 -> 0x100" ) );
+}
+
+/* TEST 8 */
+TEST( LedTrace, CapacityMustBeAPowerOfTwo )
+{
+   TEST_ASSERT_NULL( LedTrace_Create( 12 ) );
+   TEST_ASSERT_EQUAL_STRING( "LED Trace: capacity is not a power of two", RuntimeErrorStub_GetLastError() );
+   TEST_ASSERT_EQUAL( 12, RuntimeErrorStub_GetLastParameter() );
+}
+
+/* TEST 9 */
+TEST( LedTrace, EntryBeingWrittenIsDetected )
+{
+   LedDriver_TurnOn( leds, 1 );
+   LedDriver_TurnOn( leds, 2 );
+
+   LedTrace_GetTimestamp = ReadingTimestamp;
+   LedDriver_TurnOn( leds, 3 );
+
+   TEST_ASSERT_EQUAL( 0, entryBeingWritten.sequence );
+   TEST_ASSERT_EQUAL( 1, LedTrace_GetEntry( trace, 0 ).sequence );
+   TEST_ASSERT_EQUAL( 3, LedTrace_GetEntry( trace, 2 ).sequence );
+   TEST_ASSERT_EQUAL_HEX32( 0x0007, LedTrace_GetEntry( trace, 2 ).newImage );
+}
+
+TEST_GROUP_RUNNER( LedTrace )
+{
+   /* TEST 1 */
+   RUN_TEST_CASE( LedTrace, NothingRecordedAfterCreate );
+
+   /* TEST 2 */
+   RUN_TEST_CASE( LedTrace, ChangeIsRecorded );
+
+   /* TEST 3 */
+   RUN_TEST_CASE( LedTrace, UnchangedImageIsNotRecorded );
+
+   /* TEST 4 */
+   RUN_TEST_CASE( LedTrace, RingKeepsTheMostRecentChanges );
+
+   /* TEST 5 */
+   RUN_TEST_CASE( LedTrace, DetachedTraceRecordsNothing );
+
+   /* TEST 6 */
+   RUN_TEST_CASE( LedTrace, DumpOldestFirst );
+
+   /* TEST 7 */
+   RUN_TEST_CASE( LedTrace, DumpedBeforeRuntimeError );
+
+   /* TEST 8 */
+   RUN_TEST_CASE( LedTrace, CapacityMustBeAPowerOfTwo );
+
+   /* TEST 9 */
+   RUN_TEST_CASE( LedTrace, EntryBeingWrittenIsDetected );
+}
@@ -17,6 +17,13 @@ static void RunAllTests( void )
 {
     RUN_TEST_GROUP( DumbExample );
     RUN_TEST_GROUP( LedDriver );
+    RUN_TEST_GROUP( LedDriverBank );
+    RUN_TEST_GROUP( LedDriverConcurrent );
+    RUN_TEST_GROUP( LedRegisterPage );
+    RUN_TEST_GROUP( LedPwm );
+    RUN_TEST_GROUP( LedSequencer );
+    RUN_TEST_GROUP( LedTrace );
+    RUN_TEST_GROUP( LedMatrix );
 }
 
 int main( int argc, const char **argv )